@@ -25,4 +25,7 @@ template <typename T> using MatN = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynam
 // Constants
 
 inline constexpr double SQRT_2
-    = 1.414213562373095048801688724209698078569671875376948073176679737990732478462107038850387534327641572735013862309122970249248360558507372126441214970999358314132226659275055927557999505011527820605714701095599716059702745345968620147285174186408891986095523292304843087143214508397626036279952514079896872533965463318088296406206152583523950547457502877599617298355752203375318570113543746034084988471603868999706990048150305440277903164542478230684929369186215805784631115966687130130156185689872372352885092648612494977154218334204285686060146824720771435854874155657069677653720226485447015858801620758474922657226002085584466521458398893944370926591800311388246468157082630100594858704003186480342194897278290641045072636881313739855256117322040245091227700226941127573627280495738108967504018369868368450725799364729060762996941380475654823728997180326;
\ No newline at end of file
+    = 1.414213562373095048801688724209698078569671875376948073176679737990732478462107038850387534327641572735013862309122970249248360558507372126441214970999358314132226659275055927557999505011527820605714701095599716059702745345968620147285174186408891986095523292304843087143214508397626036279952514079896872533965463318088296406206152583523950547457502877599617298355752203375318570113543746034084988471603868999706990048150305440277903164542478230684929369186215805784631115966687130130156185689872372352885092648612494977154218334204285686060146824720771435854874155657069677653720226485447015858801620758474922657226002085584466521458398893944370926591800311388246468157082630100594858704003186480342194897278290641045072636881313739855256117322040245091227700226941127573627280495738108967504018369868368450725799364729060762996941380475654823728997180326;
+
+// Inverse of the Boltzmann constant (Kelvin / eV), exact from the SI definitions of e and k_B
+inline constexpr double INV_BOLTZ = 16021766340.0 / 1380649.0;
\ No newline at end of file
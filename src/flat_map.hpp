@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "cereal/cereal.hpp"
+
+// Open-addressing (linear probing) hash map. Values are stored in a std::deque hence, handles
+// (pointers to the key-value pairs) remain valid across insertions. Erasure is not supported.
+template <typename Key, typename T, typename Hash = std::hash<Key>> class FlatMap {
+  public:
+    using value_type = std::pair<Key const, T>;
+    using handle = value_type *;
+
+    FlatMap() = default;
+
+    FlatMap(FlatMap const &) = delete;
+    FlatMap &operator=(FlatMap const &) = delete;
+
+    // Moving a std::deque does not move its elements hence, handles remain valid
+    FlatMap(FlatMap &&) = default;
+    FlatMap &operator=(FlatMap &&) = default;
+
+    // Iterate in insertion order
+    auto begin() { return _values.begin(); }
+    auto end() { return _values.end(); }
+    auto begin() const { return _values.begin(); }
+    auto end() const { return _values.end(); }
+
+    std::size_t size() const { return _values.size(); }
+
+    bool empty() const { return _values.empty(); }
+
+    void clear() {
+        _values.clear();
+        _slots.clear();
+    }
+
+    // Returns nullptr if key not in map
+    handle find(Key const &key) {
+        if (_slots.empty()) {
+            return nullptr;
+        }
+
+        return _slots[probe(Hash{}(key), key)].ptr;
+    }
+
+    // Returns handle to value with key, constructed from args if .second is true
+    template <typename... Args> std::pair<handle, bool> try_emplace(Key const &key, Args &&...args) {
+        // Max load factor of 1/2
+        if (2 * (_values.size() + 1) > _slots.size()) {
+            grow();
+        }
+
+        std::size_t const hash = Hash{}(key);
+
+        slot &s = _slots[probe(hash, key)];
+
+        if (s.ptr) {
+            return {s.ptr, false};
+        }
+
+        _values.emplace_back(std::piecewise_construct,
+                             std::forward_as_tuple(key),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+
+        s = {hash, &_values.back()};
+
+        return {s.ptr, true};
+    }
+
+  private:
+    struct slot {
+        std::size_t hash;
+        handle ptr = nullptr;
+    };
+
+    std::deque<value_type> _values{};
+    std::vector<slot> _slots{};  // Size zero or a power of 2
+
+    // Index of slot holding key or the first empty slot in its probe sequence
+    std::size_t probe(std::size_t hash, Key const &key) const {
+        std::size_t const mask = _slots.size() - 1;
+
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+            if (!_slots[i].ptr || (_slots[i].hash == hash && _slots[i].ptr->first == key)) {
+                return i;
+            }
+        }
+    }
+
+    // Double the number of slots, only slots are moved
+    void grow() {
+        std::vector<slot> old(std::max<std::size_t>(16, 2 * _slots.size()));
+
+        std::swap(old, _slots);
+
+        std::size_t const mask = _slots.size() - 1;
+
+        for (auto &&s : old) {
+            if (s.ptr) {
+                std::size_t i = s.hash & mask;
+
+                while (_slots[i].ptr) {
+                    i = (i + 1) & mask;
+                }
+
+                _slots[i] = s;
+            }
+        }
+    }
+};
+
+// Serialised in the same layout as std::map by cereal/types/map.hpp
+template <class Archive, typename Key, typename T, typename Hash>
+void save(Archive &ar, FlatMap<Key, T, Hash> const &map) {
+    ar(cereal::make_size_tag(static_cast<cereal::size_type>(map.size())));
+
+    for (auto &&[key, value] : map) {
+        ar(cereal::make_map_item(key, value));
+    }
+}
+
+template <class Archive, typename Key, typename T, typename Hash>
+void load(Archive &ar, FlatMap<Key, T, Hash> &map) {
+    cereal::size_type size;
+
+    ar(cereal::make_size_tag(size));
+
+    map.clear();
+
+    for (cereal::size_type i = 0; i < size; i++) {
+        Key key;
+        T value;
+
+        ar(cereal::make_map_item(key, value));
+
+        map.try_emplace(key, std::move(value));
+    }
+}
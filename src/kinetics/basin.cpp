@@ -1,17 +1,15 @@
 #include "kinetics/basin.hpp"
 
+#include <cstdint>
+#include <optional>
 #include <random>
 #include <string>
+#include <vector>
 
+#include "config.hpp"
 #include "local/geometry.hpp"
 #include "utility.hpp"
 
-namespace {
-
-constexpr double invBoltz = 16021766340.0 / 1380649.0;  // eV^{-1}
-
-}
-
 namespace options {
 
 Basin Basin::load(toml::v2::table const &config) {
@@ -25,29 +23,53 @@ Basin Basin::load(toml::v2::table const &config) {
 
 }  // namespace options
 
-Mechanism const &Basin::local_mech::onto(Supercell &cell, std::vector<Geometry> &geos) const {
+Mechanism const &Basin::local_mech::onto(Supercell &cell,
+                                         std::vector<Geometry> const &geos,
+                                         std::vector<Catalogue::pointer> const &env,
+                                         std::vector<Mat3<double>> const &rot) const {
     //
     CHECK(_atom_idx < cell.activ.size(), "Invalid atom index");
 
     // std::cout << "abs " << env[_atom_idx]->mechs[_mech_off].abs_cap << std::endl;
 
-    // permute required if cell changed due to switcheroo(superbasin)
-    std::optional<Geometry::Result> Res = geos[_atom_idx].permute_onto(_env->delta, _env->geo);
+    Geometry const *geo = &geos[_atom_idx];
+
+    Mat3<double> R;
+
+    std::optional<Geometry> tmp;
 
-    ALWAYS_CHECK(Res, "unable to align cell & mechs geos");
+    if (env[_atom_idx] == _env) {
+        // Already aligned by canon_update
+        R = rot[_atom_idx];
+    } else {
+        // Permute required if cell changed due to switcheroo(superbasin), a copy keeps geos[i]
+        // aligned with env[i] and rot[i].
+        tmp = geos[_atom_idx];
 
-    Res->R.transposeInPlace();
+        std::optional<Geometry::Result> Res = tmp->permute_onto(_env->delta, _env->geo);
 
-    std::size_t j = 0;
+        ALWAYS_CHECK(Res, "unable to align cell & mechs geos");
 
-    for (std::size_t i = 0; i < geos[_atom_idx].size(); i++) {
-        if (geos[_atom_idx][i].col.state == Colour::activ) {
-            cell.activ[geos[_atom_idx][i].idx].vec
-                += (Res->R * _env->mechs[_mech_off].disp[j++].matrix()).array();
+        R = Res->R;
+        geo = &*tmp;
+    }
+
+    R.transposeInPlace();
+
+    Mechanism const &mech = _env->mechs[_mech_off];
+
+    auto it = mech.disp.begin();
+
+    // Only the atoms that move are rotated
+    for (std::uint32_t i = 0, slot = 0; i < geo->size() && it != mech.disp.end(); i++) {
+        if ((*geo)[i].col.state == Colour::activ) {
+            if (it->slot == slot++) {
+                cell.activ[(*geo)[i].idx].vec += (R * (it++)->vec.matrix()).array();
+            }
         }
     }
 
-    return _env->mechs[_mech_off];
+    return mech;
 }
 
 void Basin::local_mech::refine(std::vector<Geometry> &geo) const { _env.refine(geo[_atom_idx]); }
@@ -82,7 +104,7 @@ Basin::Basin(options::Basin const &opt,
             if (fwd < opt.max_barrier) {
                 CHECK(fwd > 0, "Negative energy barrier!");
 
-                double rate = env[i]->mechs[j].pre_factor * std::exp(fwd / opt.temp * -invBoltz);
+                double rate = env[i]->mechs[j].pre_factor * std::exp(fwd / opt.temp * -INV_BOLTZ);
 
                 double rev = fwd - env[i]->mechs[j].delta_energy;
 
@@ -50,8 +50,12 @@ class Basin {
             : rate(rate), barrier(barrier), _env(env), _atom_idx(atom_idx), _mech_off(mech_off) {}
 
         // Reconstruct mechanism pointed to by *this onto supercell, returns ref to mech
-        // reconstructed.
-        Mechanism const &onto(Supercell &, std::vector<Geometry> &) const;
+        // reconstructed. Reuses rot, as output by Catalogue::canon_update, unless env no longer
+        // holds the environment of this mechanism.
+        Mechanism const &onto(Supercell &,
+                              std::vector<Geometry> const &geos,
+                              std::vector<Catalogue::pointer> const &env,
+                              std::vector<Mat3<double>> const &rot) const;
 
         void refine(std::vector<Geometry> &geo) const;
 
@@ -3,11 +3,16 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <future>
 #include <cstddef>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -18,10 +23,15 @@
 #include "cereal/archives/portable_binary.hpp"
 #include "cereal/archives/xml.hpp"
 #include "config.hpp"
+#include "local/compact.hpp"
 #include "local/discrete_key.hpp"
 #include "local/environment.hpp"
 #include "local/geometry.hpp"
+#include "local/journal.hpp"
+#include "local/mapped.hpp"
+#include "local/remote.hpp"
 #include "package/package.hpp"
+#include "riften/thiefpool.hpp"
 #include "supercell.hpp"
 #include "toml++/toml.h"
 #include "utility.hpp"
@@ -35,21 +45,102 @@ Catalogue Catalogue::load(toml::v2::table const &config) {
     opt.delta = fetch<double>(config, "catalogue", "delta");
     opt.match_best = fetch<bool>(config, "catalogue", "match_best");
 
+    opt.shells = load_shells(config);
+
+    opt.descriptor = config["catalogue"]["descriptor"].value_or(opt.descriptor);
+    opt.descriptor_k = config["catalogue"]["descriptor_k"].value_or(opt.descriptor_k);
+
+    ALWAYS_CHECK(opt.descriptor_k > 0, "catalogue.descriptor_k must be positive");
+
+    opt.seed_k = config["catalogue"]["seed_k"].value_or(opt.seed_k);
+    opt.seed_delta = config["catalogue"]["seed_delta"].value_or(opt.seed_delta);
+
+    ALWAYS_CHECK(opt.seed_k == 0 || opt.seed_delta > opt.delta,
+                 "catalogue.seed_delta must exceed catalogue.delta");
+
     opt.format = config["catalogue"]["format"].value_or(opt.format);
     opt.fname = config["catalogue"]["fname"].value_or(opt.fname);
     opt.load_from_disk = config["catalogue"]["load_from_disk"].value_or(opt.load_from_disk);
 
+    opt.server = config["catalogue"]["server"].value_or(opt.server);
+
+    opt.journal = config["catalogue"]["journal"].value_or(opt.journal);
+    opt.compact_every = config["catalogue"]["compact_every"].value_or(opt.compact_every);
+
+    ALWAYS_CHECK(opt.compact_every > 0, "catalogue.compact_every must be positive");
+
+    opt.compact = config["catalogue"]["compact"].value_or(opt.compact);
+    opt.quantum = config["catalogue"]["quantum"].value_or(opt.quantum);
+    opt.disp_tol = config["catalogue"]["disp_tol"].value_or(opt.disp_tol);
+
+    ALWAYS_CHECK(opt.quantum > 0 && opt.quantum < 1, "catalogue.quantum must be in (0, 1)");
+
     return opt;
 }
 
 }  // namespace options
 
+namespace {
+
+// Serialise obj into a string using the archive selected by format
+template <typename T> std::string to_bytes(std::string const &format, T const &obj) {
+    std::ostringstream ss;
+
+    if (format == "binary") {
+        cereal::BinaryOutputArchive oarchive(ss);
+        oarchive(obj);
+    } else if (format == "json") {
+        cereal::JSONOutputArchive oarchive(ss);
+        oarchive(obj);
+    } else if (format == "portable_binary") {
+        cereal::PortableBinaryOutputArchive oarchive(ss);
+        oarchive(obj);
+    } else if (format == "xml") {
+        cereal::XMLOutputArchive oarchive(ss);
+        oarchive(obj);
+    } else {
+        ALWAYS_CHECK(false, "Invalid catalogue.format");
+    }
+
+    return ss.str();
+}
+
+}  // namespace
+
 Catalogue::Catalogue(options::Catalogue const &opt) : _opt{opt} {
     //
-    if (!_opt.load_from_disk) {
-        return;
+    if (!_opt.server.empty()) {
+        // The server owns the catalogue file, clients only read it to warm their local cache
+        _opt.journal = false;
+        _remote = std::make_unique<RemoteCatalogue>(_opt.server);
     }
 
+    if (_opt.journal) {
+        ALWAYS_CHECK(_opt.format == "binary" || _opt.format == "portable_binary"
+                         || _opt.format == "mapped",
+                     "catalogue.journal requires a binary catalogue.format");
+
+        Journal::recover(_opt.fname);
+    }
+
+    if (_opt.load_from_disk) {
+        load_from_disk();
+    }
+
+    if (_opt.journal || _remote) {
+        mark_synced();
+    }
+
+    if (_opt.journal) {
+        // Journal offsets are relative to bucket order, which optimise() may have changed, hence
+        // always start from a fresh snapshot.
+        _journal = std::make_unique<Journal>(_opt.fname);
+        _journal->compact(snapshot());
+    }
+}
+
+void Catalogue::load_from_disk() {
+    //
     std::ifstream file(_opt.fname);
 
     if (!file.good()) {
@@ -58,6 +149,10 @@ Catalogue::Catalogue(options::Catalogue const &opt) : _opt{opt} {
         return;
     }
 
+    if (_opt.format == "mapped") {
+        return load_mapped();
+    }
+
     Catalogue cat;
 
     try {
@@ -77,20 +172,221 @@ Catalogue::Catalogue(options::Catalogue const &opt) : _opt{opt} {
             ALWAYS_CHECK(false, "Invalid catalogue.format");
         }
     } catch (...) {
-        std::cerr << "Could not load catalogue, mismatched format\n";
+        std::cerr << "Could not load catalogue, mismatched catalogue.format or older file\n";
         throw;
     }
 
     ALWAYS_CHECK(_opt.r_env == cat._opt.r_env, "Catalogue incompatible with .r_env");
     ALWAYS_CHECK(_opt.delta == cat._opt.delta, "Catalogue incompatible with .delta");
+    ALWAYS_CHECK(_opt.shells == cat._opt.shells, "Catalogue incompatible with .shells");
 
     _size = std::move(cat._size);
     _catalogue = std::move(cat._catalogue);
 
+    if (_opt.journal) {
+        replay();
+    }
+
     optimise();  // Early call as nothing holds pointers yet
 }
 
+void Catalogue::load_mapped() {
+    //
+    _mapped = std::make_shared<MappedFile>(_opt.fname);
+
+    ALWAYS_CHECK(_opt.r_env == _mapped->header().r_env, "Catalogue incompatible with .r_env");
+    ALWAYS_CHECK(_opt.delta == _mapped->header().delta, "Catalogue incompatible with .delta");
+    ALWAYS_CHECK(_opt.shells == _mapped->header().shells, "Catalogue incompatible with .shells");
+
+    _size = _mapped->header().size;
+
+    for (auto &&[key, block] : _mapped->index()) {
+        _lazy.emplace(key, block);
+    }
+
+    std::cout << "Mapped " << _lazy.size() << " catalogue buckets\n";
+
+    if (_mapped->header().compact != _opt.compact) {
+        // Unread blocks are copied verbatim by snapshot() hence, must match configured encoding
+        std::cout << "Catalogue.compact changed, reading all buckets\n";
+        materialise_all();
+    }
+
+    if (_opt.journal) {
+        replay();
+    }
+
+    // No optimise(), buckets are sorted as they are read
+}
+
+std::pair<Catalogue::pointer::map_t::handle, bool> Catalogue::bucket(DiscreteKey const &key) {
+    //
+    auto [it, inserted] = _catalogue.try_emplace(key);
+
+    if (inserted) {
+        if (auto lazy = _lazy.find(key); lazy != _lazy.end()) {
+            if (_mapped->header().compact) {
+                using compact_t = std::vector<CompactEnvironment>;
+                it->second = expand(MappedFile::read<compact_t>(lazy->second));
+            } else {
+                it->second = MappedFile::read<std::vector<Environment>>(lazy->second);
+            }
+
+            _lazy.erase(lazy);
+
+            // Journal offsets are relative to the order in the snapshot
+            if (!_opt.journal) {
+                std::stable_sort(it->second.begin(), it->second.end(),
+                                 [](auto const &a, auto const &b) { return a.freq > b.freq; });
+            }
+
+            if (_opt.journal || _remote) {
+                for (auto &&env : it->second) {
+                    _synced[key].push_back({env.mechs.size(), env.search, env.delta});
+                }
+            }
+
+            return {it, false};
+        }
+    }
+
+    return {it, inserted};
+}
+
+void Catalogue::materialise_all() {
+    while (!_lazy.empty()) {
+        bucket(_lazy.begin()->first);
+    }
+}
+
+std::string Catalogue::snapshot() const {
+    //
+    if (_opt.format != "mapped") {
+        return to_bytes(_opt.format, *this);
+    }
+
+    // Unread buckets are copied verbatim from the mapping
+    std::map<DiscreteKey, std::string_view> blocks{_lazy.begin(), _lazy.end()};
+
+    std::vector<std::string> storage;
+
+    storage.reserve(_catalogue.size());  // Views into storage must remain valid
+
+    for (auto &&[k, v] : _catalogue) {
+        if (!v.empty()) {
+            if (_opt.compact) {
+                blocks.emplace(k, storage.emplace_back(MappedFile::write(compress(v))));
+            } else {
+                blocks.emplace(k, storage.emplace_back(MappedFile::write(v)));
+            }
+        }
+    }
+
+    MappedFile::Header const head{_opt.r_env, _opt.delta, _size, _opt.compact, _opt.shells};
+
+    return MappedFile::image(head, {blocks.begin(), blocks.end()});
+}
+
+std::vector<CompactEnvironment> Catalogue::compress(std::vector<Environment> const &bucket) const {
+    std::vector<CompactEnvironment> out;
+
+    for (auto &&env : bucket) {
+        out.emplace_back(env, _opt.quantum * _opt.delta, _opt.disp_tol);
+    }
+
+    return out;
+}
+
+std::vector<Environment> Catalogue::expand(std::vector<CompactEnvironment> const &bucket) {
+    std::vector<Environment> out;
+
+    for (auto &&env : bucket) {
+        out.push_back(env.expand());
+    }
+
+    return out;
+}
+
+void Catalogue::replay() {
+    //
+    std::ifstream file(Journal::journal_name(_opt.fname), std::ios::binary);
+
+    std::size_t count = 0;
+
+    while (file.good() && file.peek() != std::ifstream::traits_type::eof()) {
+        // Records are appended in batches, each with its own archive
+        std::vector<JournalEntry> batch;
+
+        try {
+            if (_opt.format == "binary") {
+                cereal::BinaryInputArchive iarchive(file);
+                iarchive(batch);
+            } else {
+                // Mapped catalogues journal in portable binary
+                cereal::PortableBinaryInputArchive iarchive(file);
+                iarchive(batch);
+            }
+        } catch (...) {
+            std::cerr << "WARNING: ignoring truncated tail of catalogue journal\n";
+            break;
+        }
+
+        for (auto &&entry : batch) {
+            apply(std::move(entry));
+        }
+
+        count += batch.size();
+    }
+
+    std::cout << "Replayed " << count << " catalogue journal records\n";
+}
+
+void Catalogue::apply(JournalEntry &&entry) {
+    //
+    std::vector<Environment> &bucket = this->bucket(entry.key).first->second;
+
+    if (entry.offset == bucket.size()) {
+        ALWAYS_CHECK(entry.env.geo.size() > 0, "Journal references missing environment");
+
+        bucket.push_back(std::move(entry.env));
+        ++_size;
+
+        return;
+    }
+
+    ALWAYS_CHECK(entry.offset < bucket.size(), "Journal references missing environment");
+
+    Environment &env = bucket[entry.offset];
+
+    ALWAYS_CHECK(entry.mech_off <= env.mechs.size(), "Journal references missing mechanism");
+
+    env.delta = entry.env.delta;
+    env.freq = entry.env.freq;
+    env.search = entry.env.search;
+
+    // Mechanisms are only ever appended hence, replay is idempotent
+    env.mechs.erase(env.mechs.begin() + entry.mech_off, env.mechs.end());
+
+    for (auto &&m : entry.env.mechs) {
+        env.mechs.push_back(std::move(m));
+    }
+}
+
+void Catalogue::mark_synced() {
+    _synced.clear();
+
+    for (auto &&[k, v] : _catalogue) {
+        for (auto &&env : v) {
+            _synced[k].push_back({env.mechs.size(), env.search, env.delta});
+        }
+    }
+}
+
 void Catalogue::optimise() {
+    _sorted.clear();
+    _described.clear();
+    _lattice.clear();
+
     for (auto &&[k, v] : _catalogue) {
         std::stable_sort(
             v.begin(), v.end(), [](auto const &a, auto const &b) { return a.freq > b.freq; });
@@ -99,13 +395,15 @@ void Catalogue::optimise() {
 
 std::vector<std::size_t> Catalogue::canon_update(std::vector<DiscreteKey> const &keys,
                                                  std::vector<Geometry> &geos,
-                                                 std::vector<Catalogue::pointer> &env) {
+                                                 std::vector<Catalogue::pointer> &env,
+                                                 std::vector<Mat3<double>> &rot) {
     env.clear();
+    rot.clear();
 
     std::vector<std::size_t> out;
 
     for (std::size_t i = 0; i < keys.size(); ++i) {
-        auto &&[ptr, inserted] = canon_try_emplace(keys[i], geos[i]);
+        auto &&[ptr, inserted] = canon_try_emplace(keys[i], geos[i], rot.emplace_back());
 
         env.push_back(ptr);
 
@@ -117,8 +415,80 @@ std::vector<std::size_t> Catalogue::canon_update(std::vector<DiscreteKey> const
     return out;
 }
 
+std::vector<std::size_t> Catalogue::canon_update(std::vector<DiscreteKey> const &keys,
+                                                 std::vector<Geometry> &geos,
+                                                 std::vector<Catalogue::pointer> &env,
+                                                 std::vector<Mat3<double>> &rot,
+                                                 std::vector<std::size_t> const &dirty) {
+    if (env.size() != keys.size() || rot.size() != keys.size()) {
+        return canon_update(keys, geos, env, rot);
+    }
+
+    std::vector<std::size_t> out;
+
+    std::vector<bool> is_dirty(keys.size(), false);
+
+    for (auto &&i : dirty) {
+        auto &&[ptr, inserted] = canon_try_emplace(keys[i], geos[i], rot[i]);
+
+        env[i] = ptr;
+        is_dirty[i] = true;
+
+        if (ptr->freq++ == 0) {
+            out.push_back(i);
+        }
+    }
+
+    // Frequencies count every atom of every update, as in the full canon_update
+    for (std::size_t i = 0; i < env.size(); ++i) {
+        if (!is_dirty[i]) {
+            env[i]->freq++;
+        }
+    }
+
+    return out;
+}
+
+std::vector<std::size_t> Catalogue::canon_refresh(std::vector<DiscreteKey> const &keys,
+                                                  std::vector<Geometry> &geos,
+                                                  std::vector<Catalogue::pointer> &env,
+                                                  std::vector<Mat3<double>> &rot,
+                                                  std::vector<std::size_t> const &dirty) {
+    std::vector<std::size_t> out;
+
+    auto refresh = [&](std::size_t i, pointer ptr) {
+        if (ptr->freq == 0) {
+            ptr->freq = 1;
+            out.push_back(i);
+        }
+    };
+
+    if (env.size() != keys.size() || rot.size() != keys.size()) {
+        env.clear();
+        rot.clear();
+
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            env.push_back(canon_try_emplace(keys[i], geos[i], rot.emplace_back()).first);
+
+            refresh(i, env.back());
+        }
+
+        return out;
+    }
+
+    for (auto &&i : dirty) {
+        env[i] = canon_try_emplace(keys[i], geos[i], rot[i]).first;
+
+        refresh(i, env[i]);
+    }
+
+    return out;
+}
+
 //   Set all frequencies to zero
 void Catalogue::reset_counts() {
+    materialise_all();
+
     for (auto &&[k, v] : _catalogue) {
         for (auto &&env : v) {
             env.freq = 0;
@@ -143,14 +513,91 @@ void Catalogue::report() const {
         std::cout << '\n';
     }
 
-    std::cout << "Found " << _size << " unique topologies in " << _catalogue.size() << " bins!\n";
+    std::cout << "Found " << _size << " unique topologies in " << _catalogue.size() + _lazy.size()
+              << " bins!\n";
+}
+
+std::vector<JournalEntry> Catalogue::changes() {
+    //
+    std::vector<JournalEntry> batch;
+
+    for (auto &&[k, v] : _catalogue) {
+        std::vector<synced> &sync = _synced[k];
+
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            synced now{v[i].mechs.size(), v[i].search, v[i].delta};
+
+            if (i == sync.size()) {
+                // New environment
+                batch.push_back({k, i, 0, v[i]});
+                sync.push_back(now);
+            } else if (sync[i].mechs != now.mechs || sync[i].search != now.search
+                       || sync[i].delta != now.delta) {
+                // Modified environment, only record new mechanisms
+                JournalEntry entry{k, i, sync[i].mechs, {}};
+
+                entry.env.delta = v[i].delta;
+                entry.env.freq = v[i].freq;
+                entry.env.search = v[i].search;
+                entry.env.mechs.assign(v[i].mechs.begin() + sync[i].mechs, v[i].mechs.end());
+
+                batch.push_back(std::move(entry));
+                sync[i] = now;
+            }
+        }
+    }
+
+    return batch;
 }
 
-void Catalogue::write() const {
+void Catalogue::write() {
     //
+    if (_remote) {
+        std::vector<std::pair<DiscreteKey, Environment>> envs;
+
+        // Server needs complete environments to match them against its own
+        for (auto &&entry : changes()) {
+            envs.emplace_back(entry.key, _catalogue.find(entry.key)->second[entry.offset]);
+        }
+
+        if (!envs.empty()) {
+            _remote->insert(std::move(envs));
+        }
+
+        return;
+    }
+
+    if (_journal) {
+        std::vector batch = changes();
+
+        // Mapped catalogues journal in portable binary
+        std::string const fmt = _opt.format == "mapped" ? "portable_binary" : _opt.format;
+
+        if (++_num_writes % _opt.compact_every == 0) {
+            std::cout << "[[COMPACT]]\n";
+            // The batch is already marked synced, it is journaled if the snapshot fails
+            _journal->compact(snapshot(), batch.empty() ? std::string{} : to_bytes(fmt, batch));
+        } else if (!batch.empty()) {
+            _journal->append(to_bytes(fmt, batch));
+        }
+
+        return;
+    }
 
     std::cout << "[[WRITE]]\n";
 
+    if (_opt.format == "mapped") {
+        // Never truncate the file backing the mapping, replace it instead
+        std::string const tmp = _opt.fname + ".tmp";
+
+        std::ofstream(tmp, std::ios::binary | std::ios::trunc) << snapshot();
+
+        ALWAYS_CHECK(std::rename(tmp.c_str(), _opt.fname.c_str()) == 0,
+                     "Could not replace " + _opt.fname);
+
+        return;
+    }
+
     std::ofstream file(_opt.fname);
 
     if (_opt.format == "binary") {
@@ -170,6 +617,276 @@ void Catalogue::write() const {
     }
 }
 
+std::optional<Catalogue::pointer> Catalogue::fetch_remote(pointer::map_t::handle it,
+                                                          DiscreteKey const &key,
+                                                          Geometry &geo,
+                                                          Mat3<double> &R) {
+    //
+    std::optional env = _remote->lookup(key, geo);
+
+    if (!env) {
+        return std::nullopt;
+    }
+
+    if (std::optional match = geo.permute_onto(env->delta, env->geo)) {
+        R = match->R;
+    } else {
+        return std::nullopt;
+    }
+
+    // Buckets are synced in order hence, this is sent back to the server on the next write(), which
+    // is harmless as merge() is idempotent.
+    it->second.push_back(std::move(*env));
+    ++_size;
+
+    return pointer(it, it->second.size() - 1);
+}
+
+std::optional<Environment> Catalogue::find(DiscreteKey const &key, Geometry &geo) {
+    //
+    auto [it, inserted] = bucket(key);
+
+    if (Mat3<double> R; !inserted) {
+        if (std::optional off = search_bucket(it, geo, R)) {
+            return it->second[*off];
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::vector<Catalogue::Seed> Catalogue::seeds(pointer env, Geometry const &geo) const {
+    //
+    if (_opt.seed_k == 0) {
+        return {};
+    }
+
+    struct candidate {
+        double dr;
+        std::size_t offset;
+        Geometry geo;  // Permuted onto the candidate
+        Mat3<double> R;
+    };
+
+    std::vector<Environment> const &bucket = env._it->second;
+
+    double const r = geo.radius();
+
+    // (|r - r_i|, offset) of the candidates, |r - r_i| is a lower bound of their distance from geo
+    std::vector<std::pair<double, std::size_t>> order;
+
+    for (std::size_t i = 0; i < bucket.size(); ++i) {
+        if (std::ptrdiff_t(i) == env._bucket_offset || bucket[i].mechs.empty()) {
+            continue;
+        }
+
+        if (double lower = std::abs(bucket[i].geo.radius() - r); lower < _opt.seed_delta) {
+            order.emplace_back(lower, i);
+        }
+    }
+
+    std::sort(order.begin(), order.end());
+
+    std::vector<candidate> near;  // Sorted by dr, at most .seed_k
+
+    for (auto &&[lower, i] : order) {
+        // Once .seed_k are found only candidates nearer than the furthest can displace it
+        double delta = near.size() < _opt.seed_k ? _opt.seed_delta : near.back().dr;
+
+        if (lower >= delta) {
+            break;
+        }
+
+        if (!geo.equiv(delta, bucket[i].geo)) {
+            continue;
+        }
+
+        Geometry mut = geo;
+
+        if (std::optional res = mut.permute_onto(delta, bucket[i].geo)) {
+            auto pos = std::upper_bound(near.begin(), near.end(), res->dr, [](double dr, auto &c) {
+                return dr < c.dr;
+            });
+
+            near.insert(pos, {res->dr, i, std::move(mut), res->R});
+
+            if (near.size() > _opt.seed_k) {
+                near.pop_back();
+            }
+        }
+    }
+
+    std::vector<Seed> out;
+
+    for (auto it = near.begin(); it != near.end(); ++it) {
+        // Mechanism slots count the active atoms of the environment in canonical order
+        std::vector<std::size_t> slots;
+
+        for (std::size_t i = 0; i < it->geo.size(); ++i) {
+            if (it->geo[i].col.state == Colour::activ) {
+                slots.push_back(it->geo[i].idx);
+            }
+        }
+
+        // Inverse of the (orthogonal) rotation of geo onto the candidate
+        Mat3<double> Rt = it->R.transpose();
+
+        for (auto &&mech : bucket[it->offset].mechs) {
+            Seed &seed = out.emplace_back();
+
+            for (auto &&elem : mech.disp) {
+                seed.emplace_back(slots[elem.slot], Rt * elem.vec.matrix());
+            }
+        }
+    }
+
+    return out;
+}
+
+void Catalogue::merge(DiscreteKey const &key, Environment &&env, options::Mechanism const &opt) {
+    _lattice.clear();
+    _size += merge_into(bucket(key).first->second, std::move(env), opt, false);
+}
+
+void Catalogue::merge(std::vector<Catalogue> &&others,
+                      options::Mechanism const &opt,
+                      riften::Thiefpool &pool) {
+    //
+    std::vector<pointer::map_t::handle> buckets;
+    std::vector<std::vector<std::vector<Environment> *>> sources;
+
+    std::map<DiscreteKey, std::size_t> index;
+
+    _lattice.clear();
+
+    // Buckets must be created up front as insertion into _catalogue is not thread-safe
+    for (auto &&cat : others) {
+        cat.materialise_all();
+
+        for (auto &&[k, v] : cat._catalogue) {
+            auto [it, inserted] = index.try_emplace(k, buckets.size());
+
+            if (inserted) {
+                buckets.push_back(bucket(k).first);
+                sources.emplace_back();
+            }
+
+            sources[it->second].push_back(&v);
+        }
+    }
+
+    std::vector<std::future<std::size_t>> futures;
+
+    for (std::size_t i = 0; i < buckets.size(); i++) {
+        futures.push_back(pool.enqueue([&, i]() {
+            std::size_t count = 0;
+
+            for (auto *src : sources[i]) {
+                for (auto &&env : *src) {
+                    count += merge_into(buckets[i]->second, std::move(env), opt, true);
+                }
+            }
+
+            return count;
+        }));
+    }
+
+    std::exception_ptr error = nullptr;
+
+    for (auto &&f : futures) {
+        if (error) {
+            // Wait for remaining futures
+            f.wait();
+        } else {
+            try {
+                _size += f.get();
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    optimise();
+}
+
+bool Catalogue::merge_into(std::vector<Environment> &dest,
+                           Environment &&env,
+                           options::Mechanism const &opt,
+                           bool sum) const {
+    // Mechanism::disp only holds active atoms, index of each atom's displacement
+    std::vector<std::size_t> slot;
+
+    for (std::size_t i = 0, n = 0; i < env.geo.size(); i++) {
+        env.geo[i].idx = i;  // Not serialised
+        slot.push_back(env.geo[i].col.state == Colour::activ ? n++ : 0);
+    }
+
+    auto match = lin_search(dest.begin(), dest.end(), env.geo);
+
+    if (match == dest.end()) {
+        // Undo any partial permutation from the failed search
+        std::vector<std::size_t> perm(env.geo.size());
+
+        for (std::size_t i = 0; i < env.geo.size(); i++) {
+            perm[env.geo[i].idx] = i;
+        }
+
+        env.geo.reorder(perm);
+
+        dest.push_back(std::move(env));
+
+        return true;
+    }
+
+    // Rotate and rearrange mechanisms onto the matched environment
+    Mat3<double> const R = env.geo.rotor_onto(match->geo);
+
+    std::vector<std::uint32_t> to_slot(slot.size());
+
+    for (std::uint32_t i = 0, n = 0; i < env.geo.size(); i++) {
+        if (env.geo[i].col.state == Colour::activ) {
+            to_slot[slot[env.geo[i].idx]] = n++;
+        }
+    }
+
+    for (auto &&m : env.mechs) {
+        std::vector<Mechanism::atom_disp> disp;
+
+        for (auto &&d : m.disp) {
+            disp.push_back({to_slot[d.slot], R * d.vec.matrix()});
+        }
+
+        std::sort(disp.begin(), disp.end(), [](auto const &a, auto const &b) {
+            return a.slot < b.slot;
+        });
+
+        match->try_push_mech({m, std::move(disp), m.abs_cap, m.rel_cap},
+                             opt.energy_abs_tol,
+                             opt.energy_frac_tol,
+                             opt.r_tol);
+    }
+
+    if (sum) {
+        match->freq += env.freq;
+        match->search += env.search;
+    } else {
+        match->freq = std::max(match->freq, env.freq);
+        match->search = std::max(match->search, env.search);
+    }
+
+    return false;
+}
+
+void Catalogue::flush() {
+    if (_journal) {
+        _journal->flush();
+    }
+}
+
 template <typename It> It Catalogue::lin_search(It beg, It end, Geometry &mut) const {
     if (_opt.match_best) {
         if (beg == end) {
@@ -208,23 +925,130 @@ template <typename It> It Catalogue::lin_search(It beg, It end, Geometry &mut) c
     }
 }
 
+std::optional<std::size_t> Catalogue::search_bucket(pointer::map_t::handle it,
+                                                     Geometry &mut,
+                                                     Mat3<double> &R) {
+    //
+    std::vector<Environment> const &bucket = it->second;
+
+    if (_opt.match_best) {
+        if (auto match = lin_search(bucket.begin(), bucket.end(), mut); match != bucket.end()) {
+            R = mut.rotor_onto(match->geo);
+            return match - bucket.begin();
+        }
+        return std::nullopt;
+    }
+
+    auto &sorted = _sorted.try_emplace(it->first).first->second;
+
+    // Environments are only ever appended to a bucket outside of optimise()
+    if (std::size_t mid = sorted.size(); mid < bucket.size()) {
+        for (std::size_t i = mid; i < bucket.size(); i++) {
+            sorted.emplace_back(bucket[i].geo.radius(), i);
+        }
+        std::sort(sorted.begin() + mid, sorted.end());
+        std::inplace_merge(sorted.begin(), sorted.begin() + mid, sorted.end());
+    }
+
+    // Every environment's delta is at most _opt.delta
+    double const r = mut.radius();
+
+    std::pair const min{r - _opt.delta, std::size_t{0}};
+    std::pair const max{r + _opt.delta, bucket.size()};
+
+    auto lo = std::lower_bound(sorted.begin(), sorted.end(), min);
+    auto hi = std::upper_bound(lo, sorted.end(), max);
+
+    if (_opt.descriptor) {
+        return search_described(it, lo, hi, mut, R);
+    }
+
+    std::vector<std::size_t> cand;
+
+    for (; lo != hi; ++lo) {
+        cand.push_back(lo->second);
+    }
+
+    // Preserve lin_search's first-match order
+    std::sort(cand.begin(), cand.end());
+
+    for (std::size_t i : cand) {
+        if (bucket[i].geo.equiv(bucket[i].delta, mut)) {
+            if (std::optional match = mut.permute_onto(bucket[i].delta, bucket[i].geo)) {
+                R = match->R;
+                return i;
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::size_t> Catalogue::search_described(pointer::map_t::handle it,
+                                                      sorted_iter beg,
+                                                      sorted_iter end,
+                                                      Geometry &mut,
+                                                      Mat3<double> &R) {
+    //
+    std::vector<Environment> const &bucket = it->second;
+
+    std::vector<Descriptor> &desc = _described.try_emplace(it->first).first->second;
+
+    for (std::size_t i = desc.size(); i < bucket.size(); i++) {
+        desc.emplace_back(bucket[i].geo, _opt.r_env);
+    }
+
+    Descriptor const query{mut, _opt.r_env};
+
+    std::vector<std::pair<double, std::size_t>> cand;
+
+    for (; beg != end; ++beg) {
+        cand.emplace_back(distance(query, desc[beg->second]), beg->second);
+    }
+
+    std::size_t const k = std::min(_opt.descriptor_k, cand.size());
+
+    std::partial_sort(cand.begin(), cand.begin() + k, cand.end());
+
+    for (std::size_t i = 0; i < k; i++) {
+        Environment const &ref = bucket[cand[i].second];
+
+        if (std::optional match = mut.permute_onto(ref.delta, ref.geo)) {
+            R = match->R;
+            return cand[i].second;
+        }
+    }
+
+    return std::nullopt;
+}
+
 // Converts geo into canonical order, inserts into _catalogue if not already there and returns a
 // reference to the topology equivalent to "t" in _catalogue.
 std::pair<Catalogue::pointer, bool> Catalogue::canon_try_emplace(DiscreteKey const &key,
-                                                                 Geometry &geo) {
+                                                                 Geometry &geo,
+                                                                 Mat3<double> &R) {
+    if (geo.lattice()) {
+        return lattice_try_emplace(key, geo, R);
+    }
+
     // "it" always points to valid bucket (possibly empty)
-    auto [it, inserted] = _catalogue.try_emplace(key);
+    auto [it, inserted] = bucket(key);
 
     if (!inserted) {
         // Existing key, must search bucket for explicit match;
-        auto match = lin_search(it->second.begin(), it->second.end(), geo);
+        if (std::optional off = search_bucket(it, geo, R)) {
+            return {pointer(it, *off), false};
+        }
+    }
 
-        // If found a match, return it
-        if (match != it->second.end()) {
-            return {pointer(it, match - it->second.begin()), false};
+    if (_remote) {
+        if (std::optional ptr = fetch_remote(it, key, geo, R)) {
+            return {*ptr, false};
         }
     }
 
+    R = Mat3<double>::Identity();
+
     // Otherwise insert new geo at end of bucket
     it->second.emplace_back(geo, _opt.delta);
     ++_size;
@@ -232,25 +1056,88 @@ std::pair<Catalogue::pointer, bool> Catalogue::canon_try_emplace(DiscreteKey con
     return {pointer(it, it->second.size() - 1), true};
 }
 
+std::pair<Catalogue::pointer, bool> Catalogue::lattice_try_emplace(DiscreteKey const &key,
+                                                                   Geometry &geo,
+                                                                   Mat3<double> &R) {
+    //
+    std::pair const tag{*geo.lattice(), key};
+
+    if (auto it = _lattice.find(tag); it != _lattice.end()) {
+        //
+        geo.reorder(it->second.perm);
+
+        Geometry const &ref = it->second.env->geo;
+
+        // Correspondence is known hence, optimal rotation is a single closed-form solve
+        Mat3<double> const rot = geo.rotor_onto(ref);
+
+        double sum_sq = 0;
+
+        for (std::size_t i = 0; i < geo.size(); ++i) {
+            sum_sq += norm_sq(ref[i].vec - (rot * geo[i].vec.matrix()).array());
+        }
+
+        // Cached permutation is not necessarily optimal hence, this is a sufficient condition
+        if (sum_sq < it->second.env->delta * it->second.env->delta) {
+            // Later matching (e.g. seeds) needs a key, the hit proved geo matches that of ref
+            geo.adopt_key(ref);
+            R = rot;
+            return {it->second.env, false};
+        }
+
+        // Strained beyond cached rotation, fall back to full canonisation
+        geo.finalise();
+
+        return canon_try_emplace(key, geo, R);
+    }
+
+    // First geometry matching this template, canonise in full and cache mapping
+    std::vector<std::size_t> order;
+
+    for (std::size_t i = 0; i < geo.size(); ++i) {
+        order.push_back(geo[i].idx);
+    }
+
+    geo.finalise();
+
+    auto [ptr, inserted] = canon_try_emplace(key, geo, R);
+
+    std::vector<std::size_t> perm;
+
+    for (std::size_t i = 0; i < geo.size(); ++i) {
+        perm.push_back(std::find(order.begin(), order.end(), geo[i].idx) - order.begin());
+    }
+
+    _lattice.emplace(tag, lattice_match{ptr, std::move(perm)});
+
+    return {ptr, inserted};
+}
+
 bool Catalogue::try_canon(std::vector<DiscreteKey> const &keys,
                           std::vector<Geometry> &geos,
                           std::vector<Catalogue::pointer> &env) {
     env.clear();
 
+    Mat3<double> R;  // Unused
+
     for (std::size_t i = 0; i < keys.size(); ++i) {
-        //
-        auto [it, inserted] = _catalogue.try_emplace(keys[i]);
+        // Lattice geometries have no fuzzy key
+        if (geos[i].lattice()) {
+            geos[i].finalise();
+        }
+
+        auto [it, inserted] = bucket(keys[i]);
 
         if (!inserted) {
             // Existing key, must search bucket for explicit match;
-            auto match = lin_search(it->second.begin(), it->second.end(), geos[i]);
-
-            // If found a match, return it
-            if (match != it->second.end()) {
-                env.push_back(pointer{it, match - it->second.begin()});
-            } else {
-                return false;
+            if (std::optional off = search_bucket(it, geos[i], R)) {
+                env.push_back(pointer{it, static_cast<std::ptrdiff_t>(*off)});
+                continue;
             }
+        }
+
+        if (std::optional ptr = _remote ? fetch_remote(it, keys[i], geos[i], R) : std::nullopt) {
+            env.push_back(*ptr);
         } else {
             return false;
         }
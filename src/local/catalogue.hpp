@@ -1,17 +1,30 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "cereal/cereal.hpp"
 #include "cereal/types/map.hpp"
 #include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
 #include "config.hpp"
+#include "flat_map.hpp"
+#include "local/compact.hpp"
+#include "local/descriptor.hpp"
 #include "local/discrete_key.hpp"
 #include "local/environment.hpp"
 #include "local/geometry.hpp"
+#include "local/journal.hpp"
+#include "local/mapped.hpp"
+#include "local/remote.hpp"
+#include "riften/thiefpool.hpp"
 #include "supercell.hpp"
 #include "toml++/toml.h"
 #include "utility.hpp"
@@ -23,14 +36,33 @@ struct Catalogue {
     double delta;     // (Angstrom), Maximum difference in L2 norm between local-environments
     bool match_best;  // If true then selects best instead of first match in catalogue
 
-    std::string format = "portable_binary";
+    std::vector<double> shells{};  // (Angstrom), Edges of radial shells resolved by DiscreteKey
+
+    bool descriptor = false;       // If true, rank candidates by symmetry-function descriptors
+    std::size_t descriptor_k = 4;  // Number of nearest candidates tested with permute_onto
+
+    std::size_t seed_k = 0;   // Number of similar searched environments that seed new searches
+    double seed_delta = 1.0;  // (Angstrom), Maximum L2 difference of seeding environments
+
+    std::string format = "portable_binary";  // Or binary, json, xml or mapped (lazily loaded)
     std::string fname = "olkmc.cat";
 
     bool load_from_disk = false;
 
+    std::string server = "";  // UNIX socket of an olkmc-server to share the catalogue through
+
+    bool journal = false;            // If true, write() appends changes to a journal
+    std::size_t compact_every = 64;  // Number of write() calls between journal compactions
+
+    bool compact = false;       // If true, write quantised environments without fuzzy keys
+    double quantum = 1. / 256;  // Quantisation step as a fraction of delta
+    double disp_tol = 1e-3;     // (Angstrom) Shorter displacements are not written if compact
+
     static Catalogue load(toml::v2::table const &config);
 
-    template <class Archive> void serialize(Archive &ar) { ar(r_env, delta, format, fname); }
+    template <class Archive> void serialize(Archive &ar) {
+        ar(r_env, delta, format, fname, compact, shells);
+    }
 };
 
 }  // namespace options
@@ -39,7 +71,7 @@ struct Catalogue {
 class Catalogue {
   public:
     struct pointer {
-        // Invalidated if _catalogue's iterators are invalidated or a call to .optimise() is made
+        // Invalidated by a call to .optimise(), bucket handles are stable across insertions
       public:
         Environment *operator->() const {
             CHECK(_bucket_offset >= 0, "Negative offset");
@@ -62,16 +94,28 @@ class Catalogue {
             _it->second.emplace_back(geo, (*this)->delta);
         }
 
+        friend bool operator==(pointer const &a, pointer const &b) {
+            return a._it == b._it && a._bucket_offset == b._bucket_offset;
+        }
+
+        // Order by identity of environment
+        friend bool operator<(pointer const &a, pointer const &b) {
+            if (a._it != b._it) {
+                return std::less<>{}(a._it, b._it);
+            }
+            return a._bucket_offset < b._bucket_offset;
+        }
+
       private:
         friend class Catalogue;
 
-        using map_t = std::map<DiscreteKey, std::vector<Environment>>;
+        using map_t = FlatMap<DiscreteKey, std::vector<Environment>>;
 
         pointer() = default;
 
-        pointer(map_t::iterator it, std::ptrdiff_t offset) : _it{it}, _bucket_offset{offset} {}
+        pointer(map_t::handle it, std::ptrdiff_t offset) : _it{it}, _bucket_offset{offset} {}
 
-        map_t::iterator _it{};
+        map_t::handle _it{};
         std::ptrdiff_t _bucket_offset{};
     };
 
@@ -82,38 +126,242 @@ class Catalogue {
     //   Sort buckets into descending frequency order
     void optimise();
 
-    // Update catalogue with new local-environments and sort geos into canonical order, returns
-    // indices of atoms in new environments.
+    // Update catalogue with new local-environments and sort geos into canonical order such that
+    // rot[i] rotates geos[i] onto env[i]->geo, returns indices of atoms in new environments.
     std::vector<std::size_t> canon_update(std::vector<DiscreteKey> const &keys,
                                           std::vector<Geometry> &geos,
-                                          std::vector<pointer> &env);
+                                          std::vector<pointer> &env,
+                                          std::vector<Mat3<double>> &rot);
+
+    // Incremental version of canon_update, only the atoms in "dirty" are canonised and have their
+    // env/rot updated, falls back to a full update if env does not match keys. Every atom's
+    // environment has its frequency incremented, as by the full update.
+    std::vector<std::size_t> canon_update(std::vector<DiscreteKey> const &keys,
+                                          std::vector<Geometry> &geos,
+                                          std::vector<pointer> &env,
+                                          std::vector<Mat3<double>> &rot,
+                                          std::vector<std::size_t> const &dirty);
+
+    // As the incremental canon_update but for revisiting a state, e.g. another basin of a
+    // superbasin, whose environments were counted on the first visit: frequencies are unchanged
+    // except those of new environments which become one, returns the indices of atoms in those.
+    std::vector<std::size_t> canon_refresh(std::vector<DiscreteKey> const &keys,
+                                           std::vector<Geometry> &geos,
+                                           std::vector<pointer> &env,
+                                           std::vector<Mat3<double>> &rot,
+                                           std::vector<std::size_t> const &dirty);
+
+    // Canonise a single geometry that is not part of the tracked state, inserting its environment
+    // if new. R is set to the rotation of geo onto the environment, its frequency is unchanged.
+    pointer canon(DiscreteKey const &key, Geometry &geo, Mat3<double> &R) {
+        return canon_try_emplace(key, geo, R).first;
+    }
 
     // Cannonise all geos, if new geo operation fails (returns false)
     bool try_canon(std::vector<DiscreteKey> const &keys,
                    std::vector<Geometry> &geos,
                    std::vector<Catalogue::pointer> &env);
 
-    void write() const;  // To disk
+    // A known mechanism mapped onto the atoms of a geometry as (geo[i].idx, displacement) pairs
+    using Seed = std::vector<std::pair<std::size_t, Vec3<double>>>;
+
+    // Mechanisms of the .seed_k environments nearest to env in its bucket, that are within
+    // .seed_delta of it and have mechanisms, rotated onto geo which must be canonised onto env.
+    // Candidates are tried in order of their radius difference, a lower bound of their distance.
+    std::vector<Seed> seeds(pointer env, Geometry const &geo) const;
+
+    // Server side of RemoteCatalogue::lookup(), if found permutes geo onto and returns a copy of
+    // the equivalent environment.
+    std::optional<Environment> find(DiscreteKey const &key, Geometry &geo);
+
+    // Server side of RemoteCatalogue::insert(), merges the mechanisms of env into the equivalent
+    // environment or inserts env if there is none.
+    void merge(DiscreteKey const &key, Environment &&env, options::Mechanism const &opt);
+
+    // Merge other catalogues into this, deduplicating environments and their mechanisms, one task
+    // per bucket is run on pool. The freq/search counts of merged environments are summed.
+    void merge(std::vector<Catalogue> &&others,
+               options::Mechanism const &opt,
+               riften::Thiefpool &pool);
+
+    // Block until all previous calls to write() have reached the disk
+    void flush();
+
+    // Number of environments
+    std::size_t size() const { return _size; }
+
+    // To disk, if journaling only the changes since the previous call are written (asynchronously),
+    // if connected to a server then changes are sent to it instead.
+    void write();
 
     void reset_counts();
 
     void report() const;
 
-    template <class Archive> void serialize(Archive &ar) { ar(_opt, _size, _catalogue); }
+    // Leading field of a serialised catalogue, identifies the layout of every type it contains. It
+    // must change whenever any of those layouts change such that older files fail to load instead
+    // of being misparsed. Older files cannot be converted, rebuild them e.g. with olkmc-prebuild.
+    static constexpr std::uint64_t format_tag = 0x33544143'4d4b4c4f;  // "OLKMCAT3" little-endian
+
+    template <class Archive> void save(Archive &ar) const {
+        ar(format_tag, _opt, _size);
+
+        if (_opt.compact) {
+            std::map<DiscreteKey, std::vector<CompactEnvironment>> buckets;
+
+            for (auto &&[k, v] : _catalogue) {
+                buckets.emplace(k, compress(v));
+            }
+
+            ar(buckets);
+        } else {
+            ar(_catalogue);
+        }
+    }
+
+    template <class Archive> void load(Archive &ar) {
+        std::uint64_t tag = 0;
+
+        ar(tag);
+
+        ALWAYS_CHECK(tag == format_tag, "Catalogue file predates the current format, rebuild it");
+
+        ar(_opt, _size);
+
+        if (_opt.compact) {
+            std::map<DiscreteKey, std::vector<CompactEnvironment>> buckets;
+
+            ar(buckets);
+
+            for (auto &&[k, v] : buckets) {
+                _catalogue.try_emplace(k, expand(v));
+            }
+        } else {
+            ar(_catalogue);
+        }
+    }
 
   private:
     options::Catalogue _opt{};
 
     std::size_t _size{};  // Number of LEs
-    std::map<DiscreteKey, std::vector<Environment>> _catalogue{};
+    pointer::map_t _catalogue{};
+
+    // Per bucket (radius, offset) pairs sorted by radius, extended lazily as buckets grow and
+    // dropped when buckets are reordered, not serialised.
+    FlatMap<DiscreteKey, std::vector<std::pair<double, std::size_t>>> _sorted{};
+
+    // Per bucket descriptors by offset if .descriptor, maintained like _sorted
+    FlatMap<DiscreteKey, std::vector<Descriptor>> _described{};
+
+    // Mapped format, buckets yet to be read from the mapping, not serialised
+    std::shared_ptr<MappedFile> _mapped{};
+    std::map<DiscreteKey, std::string_view> _lazy{};
+
+    // Environment matching a perfect-lattice template and permutation from template order to the
+    // environment's canonical order.
+    struct lattice_match {
+        pointer env;
+        std::vector<std::size_t> perm;
+    };
+
+    // Cache of (template, key) -> environment, not serialised, cleared with the pointers it holds
+    // by optimise() and merge()
+    std::map<std::pair<std::size_t, DiscreteKey>, lattice_match> _lattice{};
+
+    // State of an environment when it was last journaled
+    struct synced {
+        std::size_t mechs;
+        int search;
+        double delta;
+    };
+
+    std::unique_ptr<Journal> _journal{};
+    std::unique_ptr<RemoteCatalogue> _remote{};
+    std::size_t _num_writes{};
+    std::map<DiscreteKey, std::vector<synced>> _synced{};
 
     //////////////////////////////////////////////////////////////////////////////////////////
 
+    // Load snapshot (and replay journal) from disk
+    void load_from_disk();
+
+    // Open a mapped catalogue, only reads the bucket index
+    void load_mapped();
+
+    // Find/insert bucket, reading it from the mapping if required, .second is true if the bucket
+    // did not exist
+    std::pair<pointer::map_t::handle, bool> bucket(DiscreteKey const &key);
+
+    // Read every bucket still in the mapping
+    void materialise_all();
+
+    // Quantise a bucket for compact catalogues
+    std::vector<CompactEnvironment> compress(std::vector<Environment> const &bucket) const;
+
+    static std::vector<Environment> expand(std::vector<CompactEnvironment> const &bucket);
+
+    // Serialise the complete catalogue in the configured format
+    std::string snapshot() const;
+
+    // Replay the journal on top of a loaded snapshot
+    void replay();
+
+    // Apply a single journal record
+    void apply(JournalEntry &&entry);
+
+    // Record the current state of every environment as journaled/sent to the server
+    void mark_synced();
+
+    // Changes since previous call, relative to _synced
+    std::vector<JournalEntry> changes();
+
+    // On a local miss, fetch the server's equivalent environment (if any) into bucket "it", R is
+    // set to the rotation of geo onto it.
+    std::optional<pointer> fetch_remote(pointer::map_t::handle it,
+                                        DiscreteKey const &key,
+                                        Geometry &geo,
+                                        Mat3<double> &R);
+
+    // Merge env into dest, returns true if inserted as a new environment. If "sum" the freq/search
+    // counts of equivalent environments are summed otherwise the maximum is taken.
+    bool merge_into(std::vector<Environment> &dest,
+                    Environment &&env,
+                    options::Mechanism const &opt,
+                    bool sum) const;
+
     // Find Topology in "bucket" that is equivalent to "mut", if match is found then "mut" is
     // permuted on to it
     template <typename It> It lin_search(It beg, It end, Geometry &mut) const;
 
+    // Equivalent to lin_search over a whole bucket but, in first-match mode, only tests
+    // environments whose radius is within delta of mut's, returns offset of match. If .descriptor
+    // only the .descriptor_k of those nearest in descriptor space are tested, nearest first. On a
+    // match R is set to the rotation of mut onto it.
+    std::optional<std::size_t> search_bucket(pointer::map_t::handle it,
+                                             Geometry &mut,
+                                             Mat3<double> &R);
+
+    using sorted_iter = std::vector<std::pair<double, std::size_t>>::const_iterator;
+
+    // Tests the environments in [beg, end) of a bucket's _sorted, nearest in descriptor space first
+    std::optional<std::size_t> search_described(pointer::map_t::handle it,
+                                                sorted_iter beg,
+                                                sorted_iter end,
+                                                Geometry &mut,
+                                                Mat3<double> &R);
+
     // Converts geo into canonical order, inserts into _catalogue if not already there and
-    // returns a reference to the topology equivalent to "t" in _catalogue.
-    std::pair<pointer, bool> canon_try_emplace(DiscreteKey const &key, Geometry &geo);
+    // returns a reference to the topology equivalent to "t" in _catalogue. R is set to the
+    // rotation of geo onto the environment.
+    std::pair<pointer, bool> canon_try_emplace(DiscreteKey const &key,
+                                               Geometry &geo,
+                                               Mat3<double> &R);
+
+    // Version of canon_try_emplace for geometries in the order of a perfect-lattice template, maps
+    // them directly to a cached environment skipping the permutation search. Hits are refined with
+    // the optimal rotation and have their fuzzy key rebuilt, such that geo is as if canonised.
+    std::pair<pointer, bool> lattice_try_emplace(DiscreteKey const &key,
+                                                 Geometry &geo,
+                                                 Mat3<double> &R);
 };
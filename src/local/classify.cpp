@@ -1,51 +1,222 @@
 #include "local/classify.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 #include "local/discrete_key.hpp"
 #include "local/geometry.hpp"
+#include "local/lattice.hpp"
 #include "potentials/neigh_reduce.hpp"
 #include "supercell.hpp"
 #include "toml++/toml.h"
+#include "utility.hpp"
+
+namespace options {
+
+Classify Classify::load(toml::v2::table const &config) {
+    Classify opt;
+
+    opt.r_env = fetch<double>(config, "catalogue", "r_env");
+    opt.move_tol = config["catalogue"]["move_tol"].value_or(opt.move_tol);
+
+    opt.shells = load_shells(config);
+
+    ALWAYS_CHECK(opt.shells.empty() || opt.shells.back() < opt.r_env,
+                 "catalogue.shells must be inside r_env");
+
+    opt.lattice = Lattice::load(config);
+
+    return opt;
+}
+
+}  // namespace options
 
 Classify load_classifyer(toml::v2::table const &config) {
-    return Classify{fetch<double>(config, "catalogue", "r_env")};
+    return Classify{options::Classify::load(config)};
 }
 
-// Maps: Universe -> {[discrete_key, ..], [geometry, ...]}.
-void Classify::operator()(Supercell const &cell,
-                          std::vector<DiscreteKey> &keys,
-                          std::vector<Geometry> &geos) {
-    //
-    _reduce.load(_r_env, cell);
+Classify::Classify(options::Classify const &opt) : _opt(opt) {
+    for (auto &&lat : _opt.lattice) {
+        _lattice.emplace_back(lat, _opt.r_env);
+    }
+}
+
+void Classify::load(NeighReduce<Index> &reduce, double rcut, Supercell const &cell) {
+    reduce.load(rcut, cell);
 
     std::size_t i = 0;
     // Label atoms
-    for (auto it = _reduce.begin_activ(); it != _reduce.begin_bound(); ++it) {
+    for (auto it = reduce.begin_activ(); it != reduce.begin_bound(); ++it) {
         it->idx = i++;
     }
     // Label ghosts
-    _reduce.broadcast_ghost_data();
+    reduce.broadcast_ghost_data();
+}
+
+void Classify::begin(Vec3<double> const &vec,
+                     Colour col,
+                     std::size_t idx,
+                     DiscreteKey &key,
+                     Geometry &geo) const {
+    // Resuse memory, reduce allocation
+    key.clear();
+    geo.clear();
+
+    if (!_opt.shells.empty()) {
+        key.shells.resize((_opt.shells.size() + 1) * Colour::max());
+    }
+
+    key.centre_col = col;
+    key.sdf[col] += 1;
+    geo.emplace_back(vec, col, idx);
+}
+
+void Classify::add(Vec3<double> const &vec,
+                   Colour col,
+                   std::size_t idx,
+                   double r,
+                   DiscreteKey &key,
+                   Geometry &geo) const {
+    key.sdf[col]++;
+    geo.emplace_back(vec, col, idx);
+
+    if (!_opt.shells.empty()) {
+        auto shell = std::upper_bound(_opt.shells.begin(), _opt.shells.end(), r);
+        key.shells[(shell - _opt.shells.begin()) * Colour::max() + col]++;
+    }
+}
+
+void Classify::finish(Geometry &geo, bool tally) {
+    _num_built += tally;
+
+    // Bulk atoms skip construction of a canonical geometry
+    for (std::size_t i = 0; i < _lattice.size(); i++) {
+        if (_lattice[i].match(geo)) {
+            geo.finalise_lattice(i);
+            _num_lattice += tally;
+            return;
+        }
+    }
+
+    geo.finalise();
+}
+
+void Classify::build(NeighReduce<Index>::neigh_atom *atom, DiscreteKey &key, Geometry &geo) {
+    // As reduce does not include it/central-atom
+    begin(atom->vec, atom->col, atom->idx, key, geo);
+
+    // Add neighbours
+    _reduce.neigh_reduce(atom, [&](auto n, double r, Eigen::Array3d const &) {
+        add(n->vec, n->col, n->idx, r, key, geo);
+    });
+
+    finish(geo);
+}
+
+// Maps: Universe -> {[discrete_key, ..], [geometry, ...]}.
+void Classify::operator()(Supercell const &cell,
+                          std::vector<DiscreteKey> &keys,
+                          std::vector<Geometry> &geos) {
+    //
+    load(_reduce, _opt.r_env, cell);
 
     keys.resize(cell.activ.size());  // Usually a no-op
     geos.resize(cell.activ.size());  // Usually a no-op
 
     for (auto it = _reduce.begin_activ(); it != _reduce.begin_bound(); ++it) {
-        // Resuse memory, reduce allocation
-        keys[it->idx].clear();
-        geos[it->idx].clear();
+        build(it, keys[it->idx], geos[it->idx]);
+    }
+}
+
+void Classify::anchor(Supercell const &cell, double max_disp) {
+    // Atoms end within r_env of each other only if they started within r_env + 2 max_disp
+    load(_anchor, _opt.r_env + 2 * max_disp, cell);
+}
+
+void Classify::one(Supercell const &cell, std::size_t i, DiscreteKey &key, Geometry &geo) {
+    CHECK(i < cell.activ.size(), "Not an active atom");
+
+    auto *atom = _anchor.begin_activ() + i;
+
+    CHECK(atom < _anchor.begin_bound(), "Cell does not match anchor");
+
+    Vec3<double> centre = cell.activ[i].vec;
+
+    begin(centre, atom->col, i, key, geo);
+
+    // Neighbours of the anchor hold a superset of the neighbours in cell, bound atoms never move
+    _anchor.neigh_reduce(atom, [&](auto n, double, Eigen::Array3d const &) {
+        Vec3<double> pos = n->vec;
 
-        // As reduce does not include it/central-atom
-        keys[it->idx].centre_col = it->col;
-        keys[it->idx].sdf[it->col] += 1;
-        geos[it->idx].emplace_back(it->vec, it->col, it->idx);
+        if (n->col.state == Colour::activ) {
+            pos = cell.activ[n->idx].vec;
+        }
 
-        // Add neighbours
-        _reduce.neigh_reduce(it, [&](auto n, double, Eigen::Array3d const &) {
-            keys[it->idx].sdf[n->col]++;
-            geos[it->idx].emplace_back(n->vec, n->col, n->idx);
-        });
+        Vec3<double> dr = cell.min_image(centre, pos);
 
-        geos[it->idx].finalise();
+        if (double r = norm(dr); r < _opt.r_env) {
+            add(centre + dr, n->col, n->idx, r, key, geo);
+        }
+    });
+
+    // Configurations other than the tracked one are kept out of lattice_hit_rate()
+    finish(geo, false);
+}
+
+std::vector<std::size_t> Classify::update(Supercell const &cell,
+                                          std::vector<DiscreteKey> &keys,
+                                          std::vector<Geometry> &geos) {
+    // Full rebuild if nothing cached or the cell is incompatible with the cache
+    if (keys.size() != cell.activ.size() || geos.size() != cell.activ.size()
+        || _prev.activ.size() != cell.activ.size()
+        || !(static_cast<Simbox const &>(_prev) == static_cast<Simbox const &>(cell))) {
+        //
+        (*this)(cell, keys, geos);
+
+        _prev = cell;
+
+        _rebuilt.resize(cell.activ.size());
+        std::iota(_rebuilt.begin(), _rebuilt.end(), 0);
+
+        return _rebuilt;
+    }
+
+    _moved.clear();
+    _rebuilt.clear();
+
+    for (std::size_t i = 0; i < cell.activ.size(); ++i) {
+        if (double disp = norm(cell.min_image(_prev.activ[i].vec, cell.activ[i].vec));
+            disp > _opt.move_tol) {
+            // Atom i could have been in an environment before it moved or be in it now, unmoved
+            // atoms may have drifted up to .move_tol since their geometries were built.
+            double lim = _opt.r_env + disp + _opt.move_tol;
+            _moved.emplace_back(i, lim * lim);
+        }
     }
+
+    if (_moved.empty()) {
+        return _rebuilt;
+    }
+
+    load(_reduce, _opt.r_env, cell);
+
+    for (std::size_t i = 0; i < cell.activ.size(); ++i) {
+        for (auto &&[j, lim_sq] : _moved) {
+            if (norm_sq(cell.min_image(cell.activ[i].vec, cell.activ[j].vec)) < lim_sq) {
+                build(_reduce.begin_activ() + i, keys[i], geos[i]);
+                _rebuilt.push_back(i);
+                break;
+            }
+        }
+    }
+
+    // Only moved atoms update their reference position such that slow drifts accumulate
+    for (auto &&m : _moved) {
+        _prev.activ[m.first].vec = cell.activ[m.first].vec;
+    }
+
+    return _rebuilt;
 }
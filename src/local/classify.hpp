@@ -1,31 +1,110 @@
 #pragma once
 
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 #include "config.hpp"
 #include "local/discrete_key.hpp"
 #include "local/geometry.hpp"
+#include "local/lattice.hpp"
 #include "potentials/neigh_reduce.hpp"
 #include "supercell.hpp"
 #include "toml++/toml.h"
 
+namespace options {
+
+struct Classify {
+    double r_env;         // (Angstrom), Radius of local environment
+    double move_tol = 0;  // (Angstrom), Displacement above which an atom's neighbours are rebuilt
+
+    std::vector<double> shells{};  // (Angstrom), Edges of radial shells resolved by DiscreteKey
+
+    std::vector<Lattice> lattice{};  // Perfect-lattice templates used to short-circuit bulk atoms
+
+    static Classify load(toml::v2::table const &config);
+};
+
+}  // namespace options
+
 // Function like object that maps: Universe -> {[discrete_key, ..], [geometry, ...]}.
 class Classify {
   public:
-    explicit Classify(double r_env) : _r_env(r_env) {}
+    explicit Classify(options::Classify const &opt);
+
+    explicit Classify(double r_env) : _opt{r_env} {}
 
     void operator()(Supercell const &cell,
                     std::vector<DiscreteKey> &keys,
                     std::vector<Geometry> &geos);
 
+    // Incremental version of operator(), keys/geos must be the output of the previous call to
+    // update(). Only rebuilds the keys/geos of atoms whose environment contains an atom that has
+    // moved more than .move_tol since it was last rebuilt, returns indices of the rebuilt atoms.
+    std::vector<std::size_t> update(Supercell const &cell,
+                                    std::vector<DiscreteKey> &keys,
+                                    std::vector<Geometry> &geos);
+
+    // Build the neighbour list used by one() to classify configurations whose active atoms are
+    // displaced by at most max_disp from those of cell, e.g. the final states of its mechanisms.
+    void anchor(Supercell const &cell, double max_disp);
+
+    // Build the key and geometry of the active atom i of cell alone, cell must be within max_disp
+    // of the cell given to the last call to anchor(). Does not touch the cache used by update()
+    // hence can classify configurations other than the one being tracked.
+    void one(Supercell const &cell, std::size_t i, DiscreteKey &key, Geometry &geo);
+
+    // Fraction of all atoms built for the tracked state, by operator() or update(), that matched a
+    // perfect-lattice template
+    double lattice_hit_rate() const {
+        return _num_built > 0 ? static_cast<double>(_num_lattice) / _num_built : 0;
+    }
+
   private:
     struct Index {
         std::size_t idx;
     };
 
-    double _r_env;
+    options::Classify _opt;
 
     NeighReduce<Index> _reduce;
+    NeighReduce<Index> _anchor;  // Of the cell given to anchor(), out to r_env + 2 max_disp
+
+    std::vector<Lattice> _lattice;
+
+    std::size_t _num_built = 0;
+    std::size_t _num_lattice = 0;
+
+    Supercell _prev;                    // Positions at which each atom was last seen to move
+    std::vector<std::size_t> _rebuilt;  // Atoms rebuilt during current call to update()
+
+    // Atoms that moved since previous call to update() and their squared radius of influence
+    std::vector<std::pair<std::size_t, double>> _moved;
+
+    // Load reduce out to rcut and label atoms with their index
+    static void load(NeighReduce<Index> &reduce, double rcut, Supercell const &cell);
+
+    // Rebuild the key and geometry of a single atom, requires _reduce is loaded
+    void build(NeighReduce<Index>::neigh_atom *atom, DiscreteKey &key, Geometry &geo);
+
+    // Reset key and geo to hold only the central atom
+    void begin(Vec3<double> const &vec,
+               Colour col,
+               std::size_t idx,
+               DiscreteKey &key,
+               Geometry &geo) const;
+
+    // Add a neighbour a distance r from the central atom
+    void add(Vec3<double> const &vec,
+             Colour col,
+             std::size_t idx,
+             double r,
+             DiscreteKey &key,
+             Geometry &geo) const;
+
+    // Canonise geo once every neighbour has been added, bulk atoms skip construction. If tally, geo
+    // counts towards lattice_hit_rate().
+    void finish(Geometry &geo, bool tally = true);
 };
 
-Classify load_classifyer(toml::v2::table const &config);
\ No newline at end of file
+Classify load_classifyer(toml::v2::table const &config);
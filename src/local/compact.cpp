@@ -0,0 +1,106 @@
+#include "local/compact.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "config.hpp"
+#include "local/environment.hpp"
+#include "local/geometry.hpp"
+#include "supercell.hpp"
+#include "utility.hpp"
+
+CompactEnvironment::CompactEnvironment(Environment const &env, double step, double disp_tol)
+    : _step{step}, _delta{env.delta}, _freq{env.freq}, _search{env.search} {
+    //
+    CHECK(step > 0, "Quantisation step must be positive");
+
+    std::vector<std::int64_t> pos;
+
+    bool narrow = true;
+
+    for (std::size_t i = 0; i < env.geo.size(); i++) {
+        _col.push_back(env.geo[i].col);
+
+        for (std::size_t j = 0; j < 3; j++) {
+            std::int64_t q = std::llround(env.geo[i].vec[j] / step);
+
+            ALWAYS_CHECK(std::abs(q) <= std::numeric_limits<std::int32_t>::max(),
+                         "Quantisation step too small for geometry");
+
+            narrow = narrow && std::abs(q) <= std::numeric_limits<std::int16_t>::max();
+
+            pos.push_back(q);
+        }
+    }
+
+    if (narrow) {
+        _narrow.assign(pos.begin(), pos.end());
+    } else {
+        _wide.assign(pos.begin(), pos.end());
+    }
+
+    for (auto &&m : env.mechs) {
+        compact_mech &c = _mechs.emplace_back();
+
+        static_cast<MechBase &>(c) = m;
+
+        c.abs_cap = m.abs_cap;
+        c.rel_cap = m.rel_cap;
+
+        for (auto &&d : m.disp) {
+            if (norm(d.vec) >= disp_tol) {
+                c.idx.push_back(d.slot);
+
+                for (std::size_t j = 0; j < 3; j++) {
+                    c.disp.push_back(std::lround(d.vec[j] / step));
+                }
+            }
+        }
+    }
+}
+
+Environment CompactEnvironment::expand() const {
+    //
+    Geometry geo;
+
+    for (std::size_t i = 0; i < _col.size(); i++) {
+        Vec3<double> vec;
+
+        for (std::size_t j = 0; j < 3; j++) {
+            vec[j] = _step * (_narrow.empty() ? _wide[3 * i + j] : _narrow[3 * i + j]);
+        }
+
+        geo.emplace_back(vec, _col[i], i);
+    }
+
+    // Stored in canonical order, hence must not be re-sorted by finalise()
+    geo.rebuild_key();
+
+    Environment env{geo, _delta};
+
+    env.freq = _freq;
+    env.search = _search;
+
+    for (auto &&c : _mechs) {
+        Mechanism &m = env.mechs.emplace_back();
+
+        static_cast<MechBase &>(m) = c;
+
+        m.abs_cap = c.abs_cap;
+        m.rel_cap = c.rel_cap;
+
+        for (std::size_t k = 0; k < c.idx.size(); k++) {
+            Vec3<double> vec;
+
+            for (std::size_t j = 0; j < 3; j++) {
+                vec[j] = _step * c.disp[3 * k + j];
+            }
+
+            m.disp.push_back({c.idx[k], vec});
+        }
+    }
+
+    return env;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "cereal/types/base_class.hpp"
+#include "cereal/types/vector.hpp"
+#include "config.hpp"
+#include "local/environment.hpp"
+#include "supercell.hpp"
+#include "utility.hpp"
+
+// Quantised encoding of an Environment for compact catalogues. Positions and displacements are
+// stored as integer multiples of "step" (positions in 16 bits if they fit), displacements shorter
+// than "disp_tol" are dropped and the fuzzy key is rebuilt by expand().
+class CompactEnvironment {
+  public:
+    CompactEnvironment() = default;  // Cereal
+
+    CompactEnvironment(Environment const &env, double step, double disp_tol);
+
+    Environment expand() const;
+
+    template <class Archive> void serialize(Archive &ar) {
+        ar(_step, _col, _narrow, _wide, _delta, _freq, _search, _mechs);
+    }
+
+  private:
+    struct compact_mech : MechBase {
+        double abs_cap;
+        double rel_cap;
+
+        std::vector<std::uint32_t> idx;  // Slots of Mechanism::disp, sorted
+        std::vector<std::int32_t> disp;  // Three per entry in .idx
+
+        template <class Archive> void serialize(Archive &ar) {
+            ar(cereal::base_class<MechBase>(this), abs_cap, rel_cap, idx, disp);
+        }
+    };
+
+    double _step;
+
+    std::vector<Colour> _col;
+    std::vector<std::int16_t> _narrow;  // Positions if all fit in 16 bits
+    std::vector<std::int32_t> _wide;    // Otherwise
+
+    double _delta;
+    int _freq;
+    int _search;
+
+    std::vector<compact_mech> _mechs;
+};
@@ -0,0 +1,64 @@
+#include "local/descriptor.hpp"
+
+#include <cmath>
+#include <cstddef>
+
+#include "config.hpp"
+#include "local/geometry.hpp"
+#include "supercell.hpp"
+#include "utility.hpp"
+
+namespace {
+
+// Smooth cut-off, one at the centre falling to zero at r_env
+double cutoff(double r, double r_env) {
+    return r < r_env ? 0.5 * (std::cos(M_PI * r / r_env) + 1) : 0;
+}
+
+}  // namespace
+
+Descriptor::Descriptor(Geometry const &geo, double r_env) {
+    //
+    double const width = r_env / num_radial;
+    double const eta = 1 / (2 * width * width);
+
+    for (std::size_t j = 1; j < geo.size(); j++) {
+        //
+        Vec3<double> const dj = geo[j].vec - geo[0].vec;
+        double const rj = norm(dj);
+        double const fj = cutoff(rj, r_env);
+
+        double *g = _g.data() + geo[j].col * stride;
+
+        for (std::size_t k = 0; k < num_radial; k++) {
+            double const mu = k * r_env / (num_radial - 1);
+            g[k] += std::exp(-eta * (rj - mu) * (rj - mu)) * fj;
+        }
+
+        // Angular terms (zeta = 2, lambda = +/-1) over pairs of neighbours of the same colour
+        for (std::size_t i = 1; i < j; i++) {
+            if (geo[i].col != geo[j].col) {
+                continue;
+            }
+
+            Vec3<double> const di = geo[i].vec - geo[0].vec;
+            double const ri = norm(di);
+
+            double const cos = (di * dj).sum() / (ri * rj);
+            double const f = fj * cutoff(ri, r_env) / 2;
+
+            g[num_radial + 0] += (1 + cos) * (1 + cos) * f;
+            g[num_radial + 1] += (1 - cos) * (1 - cos) * f;
+        }
+    }
+}
+
+double distance(Descriptor const &a, Descriptor const &b) {
+    double sum_sq = 0;
+
+    for (std::size_t i = 0; i < a._g.size(); i++) {
+        sum_sq += (a._g[i] - b._g[i]) * (a._g[i] - b._g[i]);
+    }
+
+    return std::sqrt(sum_sq);
+}
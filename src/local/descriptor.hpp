@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "config.hpp"
+#include "local/geometry.hpp"
+#include "supercell.hpp"
+#include "utility.hpp"
+
+// Fixed-length, rotation and permutation invariant fingerprint of a geometry. Per colour it holds
+// Gaussian radial shells about the centre and two angular terms (Behler-Parrinello symmetry
+// functions), all smoothly cut off at r_env. Close geometries have close descriptors but not
+// vice versa hence, a match must still be confirmed with permute_onto().
+class Descriptor {
+  public:
+    static constexpr std::size_t num_radial = 16;
+    static constexpr std::size_t num_angular = 2;
+
+    Descriptor() = default;
+
+    Descriptor(Geometry const &geo, double r_env);
+
+    // Euclidean distance in descriptor space
+    friend double distance(Descriptor const &a, Descriptor const &b);
+
+  private:
+    static constexpr std::size_t stride = num_radial + num_angular;
+
+    std::array<double, Colour::max() * stride> _g{};
+};
@@ -2,21 +2,34 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <vector>
 
+#include "cereal/cereal.hpp"
 #include "cereal/types/array.hpp"
+#include "cereal/types/vector.hpp"
 #include "config.hpp"
 #include "supercell.hpp"
+#include "toml++/toml.h"
 #include "utility.hpp"
 
 // Stores histograms of atom species & central atom. Introduces lexicographical ordering that can be
-// used as a key to a std::map
+// used as a key to a std::map, also hashable
 struct DiscreteKey {
     Colour centre_col{};                   // Colour of central/first atom
     std::array<int, Colour::max()> sdf{};  // Species distribution function
 
-    // Resets sdf to zero
-    void clear() { std::fill(sdf.begin(), sdf.end(), 0); }
+    // Neighbours per radial shell (outer) and colour (inner), empty unless catalogue.shells is set
+    std::vector<int> shells{};
+
+    // Resets sdf and shells to zero
+    void clear() {
+        std::fill(sdf.begin(), sdf.end(), 0);
+        std::fill(shells.begin(), shells.end(), 0);
+    }
 
     // Strict weak ordering
     inline friend bool operator<(DiscreteKey const &a, DiscreteKey const &b) {
@@ -24,8 +37,60 @@ struct DiscreteKey {
             return a.centre_col < b.centre_col;
         }
 
-        return std::lexicographical_compare(a.sdf.begin(), a.sdf.end(), b.sdf.begin(), b.sdf.end());
+        if (a.sdf != b.sdf) {
+            return a.sdf < b.sdf;
+        }
+
+        return a.shells < b.shells;
+    }
+
+    inline friend bool operator==(DiscreteKey const &a, DiscreteKey const &b) {
+        return a.centre_col == b.centre_col && a.sdf == b.sdf && a.shells == b.shells;
+    }
+
+    // Layout changes must be accompanied by a new Catalogue::format_tag
+    template <class Archive> void serialize(Archive &ar) { ar(centre_col, sdf, shells); }
+};
+
+namespace options {
+
+// Reads catalogue.shells, the (Angstrom) edges between radial shells resolved by DiscreteKey.
+// Edges should fall between lattice shells such that vibrations do not change keys.
+inline std::vector<double> load_shells(toml::v2::table const &config) {
+    std::vector<double> out;
+
+    toml::node_view const shells = config["catalogue"]["shells"];
+
+    for (std::size_t i = 0; std::optional r = shells[i].value<double>(); i++) {
+        ALWAYS_CHECK(out.empty() || *r > out.back(), "catalogue.shells must be increasing");
+        out.push_back(*r);
     }
 
-    template <class Archive> void serialize(Archive &ar) { ar(centre_col, sdf); }
+    return out;
+}
+
+}  // namespace options
+
+namespace std {
+
+template <> struct hash<DiscreteKey> {
+    std::size_t operator()(DiscreteKey const &key) const noexcept {
+        std::uint64_t h = key.centre_col;
+
+        for (auto &&c : key.sdf) {
+            h ^= std::uint64_t(c) + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+        }
+
+        for (auto &&c : key.shells) {
+            h ^= std::uint64_t(c) + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+        }
+
+        // Finalise (splitmix64) as low bits select the slot
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111eb;
+
+        return h ^ (h >> 31);
+    }
 };
+
+}  // namespace std
@@ -15,6 +15,7 @@ Mechanism Mechanism::load(toml::v2::table const& config) {
     opt.energy_abs_tol = fetch<double>(config, "mechanism", "abs_tol");
     opt.energy_frac_tol = fetch<double>(config, "mechanism", "frac_tol");
     opt.rel_cap_tol = fetch<double>(config, "mechanism", "rel_cap_tol");
+    opt.disp_tol = config["mechanism"]["disp_tol"].value_or(opt.disp_tol);
 
     return opt;
 }
@@ -44,11 +45,25 @@ bool Mechanism::within_tol(Mechanism const& other,
     if (MechBase::within_tol(other, abs_tol, frac_tol)) {
         double sum_sq = 0;
 
-        for (std::size_t i = 0; i < disp.size(); i++) {
-            sum_sq += norm_sq(disp[i] - other.disp[i]);
+        // Merge sparse lists, absent atoms have zero displacement
+        auto a = disp.begin();
+        auto b = other.disp.begin();
+
+        while (a != disp.end() || b != other.disp.end()) {
+            if (b == other.disp.end() || (a != disp.end() && a->slot < b->slot)) {
+                sum_sq += norm_sq((a++)->vec);
+            } else if (a == disp.end() || b->slot < a->slot) {
+                sum_sq += norm_sq((b++)->vec);
+            } else {
+                sum_sq += norm_sq((a++)->vec - (b++)->vec);
+            }
+
+            if (sum_sq >= r_tol * r_tol) {
+                return false;
+            }
         }
 
-        return sum_sq < r_tol * r_tol;
+        return true;
     } else {
         return false;
     }
@@ -57,8 +72,33 @@ bool Mechanism::within_tol(Mechanism const& other,
 bool ProtoMech::within_tol(ProtoMech const& other,
                            double abs_tol,
                            double frac_tol,
-                           double r_tol) const {
-    return MechBase::within_tol(other, abs_tol, frac_tol) && norm(other.disp - disp) < r_tol;
+                           double r_tol,
+                           double disp_tol) const {
+    //
+    if (!MechBase::within_tol(other, abs_tol, frac_tol)) {
+        return false;
+    }
+
+    if (support.empty() == other.support.empty()) {
+        return norm(other.disp - disp) < r_tol;
+    }
+
+    ProtoMech const& loc = support.empty() ? other : *this;
+    ProtoMech const& full = support.empty() ? *this : other;
+
+    double sum_sq = 0;
+
+    for (std::size_t i : loc.support) {
+        Vec3<double> delta = full.disp.segment<3>(3 * i);
+
+        if (norm(delta) < disp_tol) {
+            delta = Vec3<double>::Zero();
+        }
+
+        sum_sq += norm_sq(loc.disp.segment<3>(3 * i) - delta);
+    }
+
+    return sum_sq < r_tol * r_tol;
 }
 
 std::size_t ProtoMech::find_centre() const {
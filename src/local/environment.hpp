@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <vector>
 
+#include "cereal/cereal.hpp"
 #include "cereal/types/base_class.hpp"
 #include "cereal/types/vector.hpp"
 #include "config.hpp"
@@ -17,6 +19,7 @@ struct Mechanism {
     double energy_abs_tol;   // (eV) For mechanisms to be considered distinct
     double energy_frac_tol;  // For mechanisms to be considered distinct
     double rel_cap_tol;      // Fraction of mechanism required to be captured by LE
+    double disp_tol = 1e-3;  // (Angstroms) Shorter atomic displacements are not stored
 
     static Mechanism load(toml::v2::table const& config);
 };
@@ -37,17 +40,25 @@ class MechBase {
     bool within_tol(MechBase const& other, double abs_tol, double frac_tol) const;
 };
 
-// Stores the displacement vectors for each atom in a geometry during some mechanism alongside rate
-// metadata
+// Stores the displacement vectors of the moving atoms in a geometry during some mechanism alongside
+// rate metadata
 class Mechanism : public MechBase {
   public:
-    std::vector<Vec3<double>> disp;
+    struct atom_disp {
+        std::uint32_t slot;  // Index of atom amongst the active atoms of the geometry
+        Vec3<double> vec;
+
+        template <class Archive> void serialize(Archive& ar) { ar(slot, vec); }
+    };
+
+    std::vector<atom_disp> disp;  // Sorted by slot, atoms absent did not move
 
     double abs_cap;  // L2 norm of the mechanisms displacement
     double rel_cap;  // Fraction of the L2 norm of the ProtoMech captured by this mechanism
 
     bool within_tol(Mechanism const& other, double abs_tol, double frac_tol, double r_tol) const;
 
+    // Layout changes must be accompanied by a new Catalogue::format_tag
     template <class Archive> void serialize(Archive& ar) {
         ar(cereal::base_class<MechBase>(this), disp, abs_cap, rel_cap);
     }
@@ -58,7 +69,25 @@ class ProtoMech : public MechBase {
   public:
     VecN<double> disp;
 
-    bool within_tol(ProtoMech const& other, double abs_tol, double frac_tol, double r_tol) const;
+    VecN<double> sp{};  // Displacement of the saddle point from the initial minimum
+    VecN<double> ax{};  // Dimer axis at the saddle point, empty if the searcher does not track it
+
+    double rev_pre_factor = 0;  // Of the reverse mechanism, 0 if not computed
+
+    // Rigid translation removed from disp, the final minimum is at the initial one + disp + drift
+    Vec3<double> drift = Vec3<double>::Zero();
+
+    // Atoms disp was localised to, empty if not localised. The displacements of other atoms and
+    // those shorter than disp_tol were dropped.
+    std::vector<std::size_t> support{};
+
+    // If exactly one of *this and other is localised the other is truncated onto its support, as by
+    // localisation with disp_tol, before their displacements are compared.
+    bool within_tol(ProtoMech const& other,
+                    double abs_tol,
+                    double frac_tol,
+                    double r_tol,
+                    double disp_tol) const;
 
     std::size_t find_centre() const;
 };
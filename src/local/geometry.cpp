@@ -1,5 +1,7 @@
 #include "geometry.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <optional>
 #include <utility>
@@ -11,12 +13,8 @@
 #include "local/fuzzy_key.hpp"
 #include "utility.hpp"
 
-// Must be called after all atoms emplaced
-void Geometry::finalise() {
-    // Sanity checks
-    CHECK(size() > 0, "Too few atoms in geometry");
-
-    // Make COM {0, 0, 0}
+// Make COM {0, 0, 0}
+void Geometry::centre() {
     Vec3<double> sum = {0, 0, 0};
 
     for (auto const &elem : _atoms) {
@@ -28,6 +26,16 @@ void Geometry::finalise() {
     for (auto &&elem : _atoms) {
         elem.vec -= com;
     }
+}
+
+// Must be called after all atoms emplaced
+void Geometry::finalise() {
+    // Sanity checks
+    CHECK(size() > 0, "Too few atoms in geometry");
+
+    _lattice = std::nullopt;
+
+    centre();
 
     // Order the atoms in a way that accelerates calls to permute_onto(), first atom (centre) is not
     // moved.
@@ -41,28 +49,204 @@ void Geometry::finalise() {
 
     // Build _fuzzy_key
     _fuzzy_key.build(_atoms);
+
+    _inv = invariants::build(_atoms);
 }
 
-// Return the transformation matrix R that transforms this onto "other". Uses the "Kabsch
-// algorithm" computes optimum rotation see: https://en.wikipedia.org/wiki/Kabsch_algorithm
-Mat3<double> Geometry::rotor_onto(Geometry const &other) const {
+void Geometry::finalise_lattice(std::size_t lattice) {
+    // Sanity checks
+    CHECK(size() > 0, "Too few atoms in geometry");
+
+    _lattice = lattice;
+
+    centre();
+}
+
+void Geometry::rebuild_key() {
+    CHECK(size() > 0, "Too few atoms in geometry");
+
+    _lattice = std::nullopt;
+
+    _fuzzy_key.clear();
+    _fuzzy_key.build(_atoms);
+
+    _inv = invariants::build(_atoms);
+}
+
+void Geometry::adopt_key(Geometry const &ref) {
+    CHECK(size() == ref.size(), "Geometries differ in size");
+
+    _lattice = std::nullopt;
+
+    _fuzzy_key = ref._fuzzy_key;
+
+    _inv = invariants::build(_atoms);
+}
+
+void Geometry::reorder(std::vector<std::size_t> const &perm) {
+    CHECK(perm.size() == size(), "Permutation is the wrong size");
+
+    static thread_local std::vector<geo_atom> tmp;
+
+    tmp.clear();
+
+    for (auto &&i : perm) {
+        tmp.push_back(_atoms[i]);
+    }
+
+    using std::swap;
+
+    swap(tmp, _atoms);
+}
+
+namespace {
+
+// H = sum_k a_k b_k^T, the covariance of two point sets in corresponding order
+Mat3<double> covariance(Geometry const &a, Geometry const &b) {
+    CHECK(a.size() == b.size(), "Can't rotate different sizes");
+
     Mat3<double> H = Mat3<double>::Zero();
 
-    CHECK(size() == other.size(), "Can't rotate different sizes");
+    for (std::size_t k = 0; k < a.size(); ++k) {
+        H.noalias() += a[k].vec.matrix() * b[k].vec.matrix().transpose();
+    }
 
-    for (std::size_t k = 0; k < size(); ++k) {
-        for (int i = 0; i < 3; ++i) {
-            for (int j = 0; j < 3; ++j) {
-                H(i, j) += _atoms[k].vec[i] * other[k].vec[j];
+    return H;
+}
+
+// Horn's traceless symmetric matrix, its largest eigenvalue is the maximum of tr(RH) over proper
+// rotations R and the corresponding eigenvector is the quaternion of that R.
+Eigen::Matrix4d horn(Mat3<double> const &H) {
+    double const xx = H(0, 0), xy = H(0, 1), xz = H(0, 2);
+    double const yx = H(1, 0), yy = H(1, 1), yz = H(1, 2);
+    double const zx = H(2, 0), zy = H(2, 1), zz = H(2, 2);
+
+    Eigen::Matrix4d N;
+
+    N << xx + yy + zz, yz - zy, zx - xz, xy - yx,  //
+        yz - zy, xx - yy - zz, xy + yx, zx + xz,    //
+        zx - xz, xy + yx, -xx + yy - zz, yz + zy,   //
+        xy - yx, zx + xz, yz + zy, -xx - yy + zz;
+
+    return N;
+}
+
+// Largest eigenvalue of horn(H) for det(H) >= 0, Newton's method on the characteristic polynomial
+// x^4 + c2 x^2 + c1 x + c0 (Theobald's QCP). All roots are real hence, iterating down from an upper
+// bound converges monotonically.
+double largest_eigenvalue(Eigen::Matrix4d const &N, Mat3<double> const &H) {
+    double const c2 = -2 * H.squaredNorm();
+    double const c1 = -8 * H.determinant();
+    double const c0 = N.determinant();
+
+    // Sum of singular values of H bounds the eigenvalues of N
+    double x = std::sqrt(3 * H.squaredNorm());
+
+    for (int i = 0; i < 64; ++i) {
+        double const x2 = x * x;
+        double const p = (x2 + c2) * x2 + c1 * x + c0;
+        double const dp = 4 * x2 * x + 2 * c2 * x + c1;
+
+        if (dp <= 0) {
+            break;  // Only at a repeated largest root
+        }
+
+        double const step = p / dp;
+
+        x -= step;
+
+        if (std::abs(step) <= 1e-13 * std::abs(x)) {
+            break;
+        }
+    }
+
+    return x;
+}
+
+// Eigenvector of N with eigenvalue x: the cofactors of a row of N - xI are orthogonal to the other
+// rows hence, span its null space when it has rank 3. Falls back to an iterative solver if the
+// eigenvalue is degenerate.
+Eigen::Vector4d eigenvector(Eigen::Matrix4d const &N, double x) {
+    Eigen::Matrix4d const A = N - x * Eigen::Matrix4d::Identity();
+
+    Eigen::Vector4d best = Eigen::Vector4d::Zero();
+
+    for (int r = 0; r < 4; ++r) {
+        Eigen::Vector4d v;
+
+        for (int c = 0; c < 4; ++c) {
+            Mat3<double> minor;
+
+            for (int i = 0, mi = 0; i < 4; ++i) {
+                if (i != r) {
+                    for (int j = 0, mj = 0; j < 4; ++j) {
+                        if (j != c) {
+                            minor(mi, mj++) = A(i, j);
+                        }
+                    }
+                    ++mi;
+                }
             }
+
+            v[c] = (r + c) % 2 ? -minor.determinant() : minor.determinant();
         }
+
+        if (v.squaredNorm() > best.squaredNorm()) {
+            best = v;
+        }
+    }
+
+    double const scale = A.squaredNorm();
+
+    if (best.squaredNorm() > 1e-20 * scale * scale * scale) {
+        return best.normalized();
     }
 
-    Eigen::JacobiSVD<Mat3<double>> svd(H, Eigen::ComputeFullV | Eigen::ComputeFullU);
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix4d> solver(N);
+
+    return solver.eigenvectors().col(3);
+}
+
+}  // namespace
+
+// Horn's closed-form quaternion method, equivalent to Kabsch's SVD without sign correction:
+// reflections are allowed as it's ok to reflect coordinate system. The best improper R is minus
+// the best proper rotation of -H hence, the sign of det(H) picks the branch.
+Mat3<double> Geometry::rotor_onto(Geometry const &other) const {
+    Mat3<double> H = covariance(*this, other);
+
+    double const sign = H.determinant() < 0 ? -1 : 1;
+
+    H *= sign;
+
+    Eigen::Matrix4d const N = horn(H);
+
+    Eigen::Vector4d const q = eigenvector(N, largest_eigenvalue(N, H));
+
+    double const w = q[0], x = q[1], y = q[2], z = q[3];
+
+    Mat3<double> R;
+
+    R << w * w + x * x - y * y - z * z, 2 * (x * y - w * z), 2 * (x * z + w * y),  //
+        2 * (y * x + w * z), w * w - x * x + y * y - z * z, 2 * (y * z - w * x),    //
+        2 * (z * x - w * y), 2 * (z * y + w * x), w * w - x * x - y * y + z * z;
+
+    return sign * R;
+}
+
+double Geometry::sum_sq_onto(Geometry const &other) const {
+    Mat3<double> H = covariance(*this, other);
+
+    H *= H.determinant() < 0 ? -1 : 1;
+
+    double g = 0;
 
-    // Don't do sign correction as it's ok to reflect coordinate system
+    for (std::size_t k = 0; k < size(); ++k) {
+        g += norm_sq(_atoms[k].vec) + norm_sq(other[k].vec);
+    }
 
-    return svd.matrixV() * svd.matrixU().transpose();
+    // sum |b - Ra|^2 = sum |a|^2 + |b|^2 - 2 tr(RH)
+    return std::max(0.0, g - 2 * largest_eigenvalue(horn(H), H));
 }
 
 double Geometry::norm(Geometry const &other) const {
@@ -70,7 +254,60 @@ double Geometry::norm(Geometry const &other) const {
 }
 
 bool Geometry::equiv(double tol, Geometry const &other) const {
-    return equivalent(tol, _fuzzy_key, other._fuzzy_key);
+    return _inv.close(tol, other._inv) && equivalent(tol, _fuzzy_key, other._fuzzy_key);
+}
+
+Geometry::invariants Geometry::invariants::build(std::vector<geo_atom> const &atoms) {
+    //
+    invariants inv;
+
+    Mat3<double> S = Mat3<double>::Zero();
+
+    std::array<std::size_t, Colour::max()> count{};
+
+    for (auto &&atom : atoms) {
+        S += atom.vec.matrix() * atom.vec.matrix().transpose();
+
+        if (&atom != &atoms[0]) {
+            inv.mean[atom.col] += ::norm(atom.vec - atoms[0].vec);
+            count[atom.col]++;
+        }
+    }
+
+    inv.radius = std::sqrt(S.trace());
+
+    // Eigenvalues of X^T X are the squared singular values of X, in increasing order
+    Eigen::SelfAdjointEigenSolver<Mat3<double>> solver(S, Eigen::EigenvaluesOnly);
+
+    inv.sv = solver.eigenvalues().array().max(0).sqrt();
+
+    for (std::size_t i = 0; i < Colour::max(); i++) {
+        if (count[i] > 0) {
+            inv.mean[i] /= count[i];
+        }
+    }
+
+    return inv;
+}
+
+// If |X - RY| < tol then: |X| - |Y| < tol, singular values differ by less than tol (Weyl) and
+// each distance to the centre differs by at most SQRT_2 * tol, as in the fuzzy key.
+bool Geometry::invariants::close(double tol, invariants const &other) const {
+    if (std::abs(radius - other.radius) > tol) {
+        return false;
+    }
+
+    if (((sv - other.sv).abs() > tol).any()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < Colour::max(); i++) {
+        if (std::abs(mean[i] - other.mean[i]) > SQRT_2 * tol) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 namespace {
@@ -94,16 +331,11 @@ std::optional<Geometry::Result> permute_onto(Geometry const &ref,
                                              std::size_t n) {
     // Termination criterion
     if (n >= mut.size()) {
-        Mat3<double> R = mut.rotor_onto(ref);
-
-        double sum_sq = 0;
-
-        for (std::size_t i = 0; i < mut.size(); ++i) {
-            sum_sq += norm_sq(ref[i].vec - (R * mut[i].vec.matrix()).array());
-        }
+        // Only accepted leaves need the rotation itself
+        double sum_sq = mut.sum_sq_onto(ref);
 
         if (sum_sq < delta * delta) {
-            return Geometry::Result{std::sqrt(sum_sq), R};
+            return Geometry::Result{std::sqrt(sum_sq), mut.rotor_onto(ref)};
         } else {
             return std::nullopt;
         }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -38,6 +39,8 @@ class Geometry {
     void clear() {
         _atoms.clear();
         _fuzzy_key.clear();
+        _inv = {};
+        _lattice = std::nullopt;
     }
 
     template <typename... Args> void emplace_back(Args &&...args) {
@@ -47,10 +50,32 @@ class Geometry {
     // Must be called after all atoms emplaced
     void finalise();
 
-    // Return the transformation matrix R that transforms this onto "other". Uses the "Kabsch
-    // algorithm" computes optimum rotation see: https://en.wikipedia.org/wiki/Kabsch_algorithm
+    // Alternative to finalise() for geometries already in the order of a perfect-lattice template,
+    // makes COM {0, 0, 0} but skips sorting and building the fuzzy key.
+    void finalise_lattice(std::size_t lattice);
+
+    // Rebuild the fuzzy key of a geometry deserialised without one, atoms are not reordered
+    void rebuild_key();
+
+    // Cheap alternative to rebuild_key() for a geometry known to permute onto ref in its current
+    // order: adopts the fuzzy key of ref and rebuilds only the O(n) invariants.
+    void adopt_key(Geometry const &ref);
+
+    // Index of the lattice template if this was finalised by finalise_lattice()
+    std::optional<std::size_t> lattice() const { return _lattice; }
+
+    // Permute atoms such that new[i] = old[perm[i]]
+    void reorder(std::vector<std::size_t> const &perm);
+
+    // Return the transformation matrix R that transforms this onto "other". Computes the optimum
+    // rotation (reflections allowed) of the "Kabsch algorithm" in closed form using Horn's
+    // quaternion method, see: https://doi.org/10.1364/JOSAA.4.000629
     Mat3<double> rotor_onto(Geometry const &other) const;
 
+    // Minimum over R of the squared l2-norm between "other" and this after rotation by R, without
+    // constructing R.
+    double sum_sq_onto(Geometry const &other) const;
+
     struct Result {
         double dr;       // l2-norm
         Mat3<double> R;  // Required rotation
@@ -62,11 +87,38 @@ class Geometry {
 
     double norm(Geometry const &other) const;
 
+    // Tests invariants then fuzzy keys, necessary conditions for permute_onto(tol, other)
     bool equiv(double tol, Geometry const &other) const;
 
-    template <class Archive> void serialize(Archive &ar) { ar(_atoms, _fuzzy_key); }
+    // L2 norm of the positions, changes by at most delta between geometries that permute_onto
+    // each other hence, used to sort catalogue buckets.
+    double radius() const { return _inv.radius; }
+
+    template <class Archive> void save(Archive &ar) const { ar(_atoms, _fuzzy_key); }
+
+    template <class Archive> void load(Archive &ar) {
+        ar(_atoms, _fuzzy_key);
+        _inv = invariants::build(_atoms);
+    }
 
   private:
+    // Rotation/permutation invariant scalars that cheaply reject candidates for permute_onto
+    struct invariants {
+        double radius = 0;                          // L2 norm of positions
+        Vec3<double> sv = Vec3<double>::Zero();     // Sorted singular values of positions
+        std::array<double, Colour::max()> mean{};  // Per colour mean distance from centre
+
+        static invariants build(std::vector<geo_atom> const &atoms);
+
+        bool close(double tol, invariants const &other) const;
+    };
+
     std::vector<geo_atom> _atoms{};
     fuzzy_key _fuzzy_key;
+    invariants _inv{};  // Not serialised, rebuilt on load
+
+    std::optional<std::size_t> _lattice{};  // Deliberately not serialised
+
+    // Make COM {0, 0, 0}
+    void centre();
 };
@@ -0,0 +1,221 @@
+#include "local/journal.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace {
+
+std::string tmp_name(std::string const &fname) { return fname + ".tmp"; }
+
+std::string commit_name(std::string const &fname) { return fname + ".commit"; }
+
+bool exists(std::string const &fname) { return std::ifstream(fname).good(); }
+
+// FNV-1a
+std::uint64_t checksum(std::string const &bytes) {
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (unsigned char c : bytes) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// Write bytes to fname and fsync it, returns false on any failure
+bool write_synced(std::string const &fname, std::string const &bytes) {
+    int fd = ::open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    std::size_t done = 0;
+
+    while (done < bytes.size()) {
+        ssize_t n = ::write(fd, bytes.data() + done, bytes.size() - done);
+
+        if (n <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        done += n;
+    }
+
+    bool ok = ::fsync(fd) == 0;
+
+    return ::close(fd) == 0 && ok;
+}
+
+// Make renames/removals in the directory of fname durable
+void sync_dir(std::string const &fname) {
+    std::filesystem::path dir = std::filesystem::path(fname).parent_path();
+
+    if (int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY); fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+// Append bytes to the journal of fname, returns false on any failure
+bool append_journal(std::string const &fname, std::string const &bytes) {
+    std::ofstream file(Journal::journal_name(fname), std::ios::binary | std::ios::app);
+    file.write(bytes.data(), bytes.size());
+    file.flush();
+
+    return file.good();
+}
+
+// Remove the journal and install the temporary snapshot, which must be committed
+void install(std::string const &fname) {
+    std::remove(Journal::journal_name(fname).c_str());
+
+    if (exists(tmp_name(fname))) {
+        std::rename(tmp_name(fname).c_str(), fname.c_str());
+    }
+
+    std::ofstream{Journal::journal_name(fname), std::ios::binary | std::ios::trunc};
+
+    sync_dir(fname);
+
+    std::remove(commit_name(fname).c_str());
+}
+
+}  // namespace
+
+Journal::Journal(std::string const &fname) : _fname(fname), _thread([this] { run(); }) {}
+
+Journal::~Journal() {
+    {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_one();
+    _thread.join();
+}
+
+void Journal::append(std::string &&bytes) {
+    {
+        std::lock_guard lock(_mutex);
+        _queue.push_back({false, std::move(bytes), {}});
+        ++_pending;
+    }
+    _cv.notify_one();
+}
+
+void Journal::compact(std::string &&bytes, std::string &&fallback) {
+    {
+        std::lock_guard lock(_mutex);
+        _queue.push_back({true, std::move(bytes), std::move(fallback)});
+        ++_pending;
+    }
+    _cv.notify_one();
+}
+
+void Journal::flush() {
+    std::unique_lock lock(_mutex);
+    _done.wait(lock, [&] { return _pending == 0; });
+}
+
+// The commit marker holds the length and checksum of the temporary snapshot and is only written
+// once the temporary is synced. Without a marker the temporary may be incomplete and is discarded,
+// the old snapshot plus journal is then the current state.
+void Journal::recover(std::string const &fname) {
+    //
+    if (!exists(commit_name(fname))) {
+        if (exists(tmp_name(fname))) {
+            std::cout << "Discarding uncommitted catalogue snapshot\n";
+            std::remove(tmp_name(fname).c_str());
+        }
+        return;
+    }
+
+    std::uint64_t length = 0;
+    std::uint64_t sum = 0;
+
+    std::ifstream(commit_name(fname)) >> length >> sum;
+
+    if (std::ifstream tmp{tmp_name(fname), std::ios::binary}) {
+        std::string bytes{std::istreambuf_iterator<char>(tmp), std::istreambuf_iterator<char>()};
+
+        if (bytes.size() != length || checksum(bytes) != sum) {
+            // Only possible if the marker itself was partially written
+            std::cerr << "WARNING: committed catalogue snapshot is corrupt, discarding it\n";
+            std::remove(tmp_name(fname).c_str());
+            std::remove(commit_name(fname).c_str());
+            return;
+        }
+    }
+
+    // If the temporary is missing it has already been renamed over fname
+    std::cout << "Recovering interrupted catalogue compaction\n";
+
+    install(fname);
+}
+
+void Journal::run() {
+    for (bool prev = false;; prev = true) {
+        job next;
+
+        {
+            std::unique_lock lock(_mutex);
+
+            if (prev) {
+                // Previous job is complete
+                --_pending;
+                _done.notify_all();
+            }
+
+            _cv.wait(lock, [&] { return _stop || !_queue.empty(); });
+
+            if (_queue.empty()) {
+                return;  // Implies _stop
+            }
+
+            next = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        auto &&[snapshot, bytes, fallback] = next;
+
+        if (snapshot) {
+            // Order is important for recover(): the journal must only be removed after the
+            // temporary snapshot is synced and committed.
+            std::ostringstream marker;
+
+            marker << bytes.size() << ' ' << checksum(bytes) << '\n';
+
+            if (!write_synced(tmp_name(_fname), bytes)
+                || !write_synced(commit_name(_fname), marker.str())) {
+                std::cerr << "WARNING: failed to write catalogue snapshot\n";
+                std::remove(commit_name(_fname).c_str());
+
+                // The old snapshot and journal are intact, keep the changes in the journal
+                if (!fallback.empty() && !append_journal(_fname, fallback)) {
+                    std::cerr << "WARNING: failed to append to catalogue journal\n";
+                }
+                continue;
+            }
+
+            sync_dir(_fname);
+
+            install(_fname);
+        } else {
+            if (!append_journal(_fname, bytes)) {
+                std::cerr << "WARNING: failed to append to catalogue journal\n";
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "config.hpp"
+#include "local/discrete_key.hpp"
+#include "local/environment.hpp"
+#include "utility.hpp"
+
+// Journal record of the changes to a single environment in the catalogue.
+struct JournalEntry {
+    DiscreteKey key;         // Of bucket containing environment
+    std::uint64_t offset;    // Of environment in bucket
+    std::uint64_t mech_off;  // Number of mechanisms preceding .env.mechs
+    Environment env;         // .env.geo is empty unless environment is new
+
+    template <class Archive> void serialize(Archive &ar) { ar(key, offset, mech_off, env); }
+};
+
+// Owns a background thread that performs all file-system writes of the catalogue, in order, such
+// that the caller never blocks on disk. Files used are: "fname" (snapshot), "fname.journal"
+// (records appended since snapshot), "fname.tmp" (snapshot under construction) and "fname.commit"
+// (present once "fname.tmp" is complete and synced, until it replaces "fname").
+class Journal {
+  public:
+    explicit Journal(std::string const &fname);
+
+    Journal(Journal const &) = delete;
+    Journal &operator=(Journal const &) = delete;
+
+    // Completes all queued writes
+    ~Journal();
+
+    // Queue serialised records for appending to the journal
+    void append(std::string &&bytes);
+
+    // Queue atomic replacement of the snapshot by serialised catalogue and truncation of journal.
+    // If the snapshot cannot be written the serialised records in fallback, the changes since the
+    // last write, are appended to the journal instead such that none are lost.
+    void compact(std::string &&bytes, std::string &&fallback = {});
+
+    // Block until all queued writes are complete
+    void flush();
+
+    // Complete a compaction interrupted after its snapshot was committed, else discard any partial
+    // snapshot.
+    static void recover(std::string const &fname);
+
+    static std::string journal_name(std::string const &fname) { return fname + ".journal"; }
+
+  private:
+    std::string _fname;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::condition_variable _done;
+    struct job {
+        bool snapshot;
+        std::string bytes;
+        std::string fallback;  // Records to append if a snapshot fails
+    };
+
+    std::deque<job> _queue;
+    std::size_t _pending = 0;  // Queued or in progress
+    bool _stop = false;
+
+    std::thread _thread;
+
+    void run();
+};
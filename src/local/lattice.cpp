@@ -0,0 +1,123 @@
+#include "local/lattice.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "config.hpp"
+#include "local/geometry.hpp"
+#include "toml++/toml.h"
+#include "utility.hpp"
+
+namespace options {
+
+std::vector<Lattice> Lattice::load(toml::v2::table const &config) {
+    std::vector<Lattice> out;
+
+    for (std::size_t i = 0; toml::node_view lat = config["catalogue"]["lattice"][i]; i++) {
+        Lattice opt;
+
+        opt.kind = fetch<std::string>(lat, "kind");
+
+        ALWAYS_CHECK(std::find(valid.begin(), valid.end(), opt.kind) != valid.end(),
+                     "Invalid lattice kind: " + opt.kind);
+
+        opt.a = fetch<double>(lat, "a");
+        opt.tol = fetch<double>(lat, "tol");
+
+        out.push_back(std::move(opt));
+    }
+
+    return out;
+}
+
+}  // namespace options
+
+namespace {
+
+// Test if site (in units of a/2) is a lattice point of a cubic lattice of kind
+bool is_site(std::string const &kind, int i, int j, int k) {
+    auto even = [](int x) { return x % 2 == 0; };
+
+    if (kind == "SC") {
+        return even(i) && even(j) && even(k);
+    } else if (kind == "BCC") {
+        return even(i) == even(j) && even(j) == even(k);
+    } else if (kind == "FCC") {
+        return even(i + j + k);
+    } else {
+        ALWAYS_CHECK(false, "Invalid lattice kind: " + kind);
+    }
+}
+
+}  // namespace
+
+Lattice::Lattice(options::Lattice const &opt, double r_env)
+    : _opt(opt), _n(std::ceil(2 * r_env / opt.a) + 1), _size(0) {
+    //
+    int w = 2 * _n + 1;
+
+    _site.assign(w * w * w, -1);
+
+    double const half = 0.5 * _opt.a;
+
+    for (int k = -_n; k <= _n; k++) {
+        for (int j = -_n; j <= _n; j++) {
+            for (int i = -_n; i <= _n; i++) {
+                if ((i != 0 || j != 0 || k != 0) && is_site(_opt.kind, i, j, k)
+                    && half * half * (i * i + j * j + k * k) < r_env * r_env) {
+                    _site[(i + _n) + (j + _n) * w + (k + _n) * w * w] = 1 + _size++;
+                }
+            }
+        }
+    }
+
+    _perm.resize(_size + 1);
+}
+
+bool Lattice::match(Geometry &geo) {
+    if (geo.size() != _size + 1) {
+        return false;
+    }
+
+    int const w = 2 * _n + 1;
+    double const half = 0.5 * _opt.a;
+
+    std::fill(_perm.begin(), _perm.end(), 0);
+
+    for (std::size_t m = 1; m < geo.size(); m++) {
+        if (geo[m].col != geo[0].col) {
+            return false;
+        }
+
+        Vec3<double> s = (geo[m].vec - geo[0].vec) / half;
+        Vec3<double> r = s.round();
+
+        if (norm_sq(s - r) * half * half > _opt.tol * _opt.tol) {
+            return false;
+        }
+
+        if ((r.abs() > _n).any()) {
+            return false;
+        }
+
+        int i = r[0] + _n;
+        int j = r[1] + _n;
+        int k = r[2] + _n;
+
+        std::ptrdiff_t slot = _site[i + j * w + k * w * w];
+
+        // Not a lattice site or site already occupied
+        if (slot < 0 || _perm[slot] != 0) {
+            return false;
+        }
+
+        _perm[slot] = m;
+    }
+
+    geo.reorder(_perm);
+
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "config.hpp"
+#include "local/geometry.hpp"
+#include "supercell.hpp"
+#include "toml++/toml.h"
+#include "utility.hpp"
+
+namespace options {
+
+struct Lattice {
+    static constexpr std::array valid = {"SC", "BCC", "FCC"};
+
+    std::string kind;  // Must be in valid
+    double a;          // (Angstrom), Lattice constant of the conventional cubic cell
+    double tol;        // (Angstrom), Maximum deviation of an atom from its ideal lattice site
+
+    // Parse every "catalogue.lattice" table
+    static std::vector<Lattice> load(toml::v2::table const &config);
+};
+
+}  // namespace options
+
+// Perfect-crystal template of a cubic lattice aligned with the simbox axes. Recognises the
+// environments of bulk atoms from their neighbours' offsets alone, such that they can skip the
+// construction of a canonical geometry.
+class Lattice {
+  public:
+    Lattice(options::Lattice const &opt, double r_env);
+
+    // Number of atoms (including the centre) in a perfect environment
+    std::size_t size() const { return _size + 1; }
+
+    // Test if "geo" (centre first, not finalised) is a perfect environment of this lattice, all
+    // atoms must share the centre's colour. If it is, atoms in "geo" are put in template order.
+    bool match(Geometry &geo);
+
+  private:
+    options::Lattice _opt;
+
+    int _n;                             // Half width of _site, in units of a/2
+    std::size_t _size;                  // Number of neighbours in a perfect environment
+    std::vector<std::ptrdiff_t> _site;  // Maps site offset (units of a/2) to position in template
+
+    std::vector<std::size_t> _perm;  // Scratch space for match()
+};
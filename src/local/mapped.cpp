@@ -0,0 +1,124 @@
+#include "local/mapped.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "cereal/archives/portable_binary.hpp"
+#include "cereal/types/vector.hpp"
+#include "local/discrete_key.hpp"
+#include "utility.hpp"
+
+namespace {
+
+// Changes with Catalogue::format_tag, blocks hold the same serialised types
+constexpr std::string_view magic = "OLKMCMP3";
+
+constexpr std::size_t len_size = 8;  // Bytes in little-endian header length
+
+}  // namespace
+
+MappedFile::MappedFile(std::string const &fname) {
+    //
+    int fd = ::open(fname.c_str(), O_RDONLY);
+
+    ALWAYS_CHECK(fd >= 0, "Could not open mapped catalogue: " + fname);
+
+    struct stat st;
+
+    if (::fstat(fd, &st) != 0 || std::size_t(st.st_size) < magic.size() + len_size) {
+        ::close(fd);
+        ALWAYS_CHECK(false, "Not a mapped catalogue: " + fname);
+    }
+
+    _length = st.st_size;
+    _data = ::mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    ::close(fd);  // Mapping keeps file alive
+
+    ALWAYS_CHECK(_data != MAP_FAILED, "Could not mmap catalogue: " + fname);
+
+    // Buckets are accessed in no particular order
+    ::madvise(_data, _length, MADV_RANDOM);
+
+    std::string_view file{static_cast<char const *>(_data), _length};
+
+    ALWAYS_CHECK(file.substr(0, magic.size()) == magic, "Not a mapped catalogue: " + fname);
+
+    std::uint64_t head_len = 0;
+
+    for (std::size_t i = 0; i < len_size; i++) {
+        head_len |= std::uint64_t(static_cast<unsigned char>(file[magic.size() + i])) << (8 * i);
+    }
+
+    std::size_t const begin = magic.size() + len_size;
+
+    ALWAYS_CHECK(begin + head_len <= _length, "Truncated mapped catalogue: " + fname);
+
+    std::vector<index_entry> index;
+
+    {
+        membuf buf(file.substr(begin, head_len));
+        std::istream is(&buf);
+        cereal::PortableBinaryInputArchive iarchive(is);
+        iarchive(_header, index);
+    }
+
+    std::string_view blocks = file.substr(begin + head_len);
+
+    for (auto &&entry : index) {
+        ALWAYS_CHECK(entry.offset + entry.length <= blocks.size(), "Truncated mapped catalogue");
+        _index.emplace_back(entry.key, blocks.substr(entry.offset, entry.length));
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (_data && _data != MAP_FAILED) {
+        ::munmap(_data, _length);
+    }
+}
+
+std::string MappedFile::image(Header const &header,
+                              std::vector<std::pair<DiscreteKey, std::string_view>> const &blocks) {
+    //
+    std::vector<index_entry> index;
+
+    std::uint64_t offset = 0;
+
+    for (auto &&[key, block] : blocks) {
+        index.push_back({key, offset, block.size()});
+        offset += block.size();
+    }
+
+    std::ostringstream head;
+
+    {
+        cereal::PortableBinaryOutputArchive oarchive(head);
+        oarchive(header, index);
+    }
+
+    std::string out{magic};
+
+    std::uint64_t const head_len = head.str().size();
+
+    for (std::size_t i = 0; i < len_size; i++) {
+        out.push_back(static_cast<char>((head_len >> (8 * i)) & 0xFF));
+    }
+
+    out += head.str();
+
+    for (auto &&[key, block] : blocks) {
+        out += block;
+    }
+
+    return out;
+}
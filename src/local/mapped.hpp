@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "cereal/archives/portable_binary.hpp"
+#include "cereal/types/vector.hpp"
+#include "config.hpp"
+#include "local/discrete_key.hpp"
+#include "utility.hpp"
+
+// Read-optimised catalogue file: a magic string, the length of the header, a header holding the
+// bucket index then one independently deserialisable block per bucket. Opened files are
+// memory-mapped hence, buckets are only read from disk when first deserialised.
+class MappedFile {
+  public:
+    struct Header {
+        double r_env;
+        double delta;
+        std::uint64_t size;  // Number of environments
+        bool compact;        // Blocks hold CompactEnvironment
+
+        std::vector<double> shells;  // Of the keys, see options::Catalogue
+
+        template <class Archive> void serialize(Archive &ar) {
+            ar(r_env, delta, size, compact, shells);
+        }
+    };
+
+    // Map file into memory and parse header, throws if file is not a mapped catalogue
+    explicit MappedFile(std::string const &fname);
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile &operator=(MappedFile const &) = delete;
+
+    ~MappedFile();
+
+    Header const &header() const { return _header; }
+
+    // Serialised block of each bucket, views into the mapping, in key order
+    std::vector<std::pair<DiscreteKey, std::string_view>> const &index() const { return _index; }
+
+    template <typename T> static T read(std::string_view block) {
+        T obj;
+
+        membuf buf(block);
+        std::istream is(&buf);
+        cereal::PortableBinaryInputArchive iarchive(is);
+        iarchive(obj);
+
+        return obj;
+    }
+
+    template <typename T> static std::string write(T const &obj) {
+        std::ostringstream ss;
+
+        {
+            cereal::PortableBinaryOutputArchive oarchive(ss);
+            oarchive(obj);
+        }
+
+        return ss.str();
+    }
+
+    // Build a complete file from a header and the serialised block of each bucket, in key order
+    static std::string image(Header const &header,
+                             std::vector<std::pair<DiscreteKey, std::string_view>> const &blocks);
+
+  private:
+    // Read-only stream buffer over a block of memory
+    struct membuf : std::streambuf {
+        explicit membuf(std::string_view view) {
+            char *p = const_cast<char *>(view.data());
+            setg(p, p, p + view.size());
+        }
+    };
+
+    struct index_entry {
+        DiscreteKey key;
+        std::uint64_t offset;  // Relative to start of first block
+        std::uint64_t length;
+
+        template <class Archive> void serialize(Archive &ar) { ar(key, offset, length); }
+    };
+
+    void *_data = nullptr;
+    std::size_t _length = 0;
+
+    Header _header;
+    std::vector<std::pair<DiscreteKey, std::string_view>> _index;
+};
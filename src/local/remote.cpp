@@ -0,0 +1,282 @@
+#include "local/remote.hpp"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cereal/archives/portable_binary.hpp"
+#include "config.hpp"
+#include "local/catalogue.hpp"
+#include "local/discrete_key.hpp"
+#include "local/environment.hpp"
+#include "utility.hpp"
+
+namespace {
+
+constexpr std::size_t len_size = 8;
+
+constexpr int peer_timeout = 5000;  // (ms) Server drops clients that stall mid-frame
+
+constexpr std::uint64_t max_frame = std::uint64_t(1) << 30;  // (bytes) Longer frames are malformed
+
+// Write all of buf, false on failure
+bool write_all(int fd, char const *buf, std::size_t n) {
+    while (n > 0) {
+        ssize_t k = ::send(fd, buf, n, MSG_NOSIGNAL);
+
+        if (k < 0 && errno == EINTR) {
+            continue;
+        } else if (k <= 0) {
+            return false;
+        }
+
+        buf += k;
+        n -= k;
+    }
+
+    return true;
+}
+
+// Read exactly n bytes into buf, false on failure, EOF or if no data arrives for timeout (ms), a
+// negative timeout waits forever
+bool read_all(int fd, char *buf, std::size_t n, int timeout) {
+    while (n > 0) {
+        if (timeout >= 0) {
+            pollfd p{fd, POLLIN, 0};
+
+            if (int r = ::poll(&p, 1, timeout); r < 0 && errno == EINTR) {
+                continue;
+            } else if (r <= 0) {
+                return false;
+            }
+        }
+
+        ssize_t k = ::read(fd, buf, n);
+
+        if (k < 0 && errno == EINTR) {
+            continue;
+        } else if (k <= 0) {
+            return false;
+        }
+
+        buf += k;
+        n -= k;
+    }
+
+    return true;
+}
+
+template <typename T> bool send_frame(int fd, T const &obj) {
+    std::ostringstream ss;
+
+    {
+        cereal::PortableBinaryOutputArchive oarchive(ss);
+        oarchive(obj);
+    }
+
+    std::string const body = ss.str();
+
+    char head[len_size];
+
+    for (std::size_t i = 0; i < len_size; i++) {
+        head[i] = static_cast<char>((std::uint64_t(body.size()) >> (8 * i)) & 0xFF);
+    }
+
+    return write_all(fd, head, len_size) && write_all(fd, body.data(), body.size());
+}
+
+template <typename T> bool recv_frame(int fd, T &obj, int timeout = -1) {
+    unsigned char head[len_size];
+
+    if (!read_all(fd, reinterpret_cast<char *>(head), len_size, timeout)) {
+        return false;
+    }
+
+    std::uint64_t len = 0;
+
+    for (std::size_t i = 0; i < len_size; i++) {
+        len |= std::uint64_t(head[i]) << (8 * i);
+    }
+
+    if (len > max_frame) {
+        return false;
+    }
+
+    std::string body(len, '\0');
+
+    if (!read_all(fd, body.data(), len, timeout)) {
+        return false;
+    }
+
+    // A malformed body only costs the connection it arrived on
+    try {
+        std::istringstream ss(std::move(body));
+        cereal::PortableBinaryInputArchive iarchive(ss);
+        iarchive(obj);
+    } catch (std::exception const &err) {
+        std::cerr << "Malformed frame: " << err.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+sockaddr_un socket_address(std::string const &path) {
+    sockaddr_un addr{};
+
+    ALWAYS_CHECK(path.size() < sizeof(addr.sun_path), "Socket path too long: " + path);
+
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    return addr;
+}
+
+volatile std::sig_atomic_t stop = 0;
+
+}  // namespace
+
+namespace remote {
+
+void serve(Catalogue &cat, options::Mechanism const &opt, std::string const &path) {
+    //
+    sockaddr_un addr = socket_address(path);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    ALWAYS_CHECK(listener >= 0, "Could not create socket");
+
+    // Do not steal the socket of a live server, otherwise remove any stale socket file
+    if (::connect(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+        ::close(listener);
+        ALWAYS_CHECK(false, "A catalogue server is already listening on: " + path);
+    }
+
+    ::close(listener);
+    ::unlink(path.c_str());
+
+    listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    ALWAYS_CHECK(listener >= 0, "Could not create socket");
+    ALWAYS_CHECK(::bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0,
+                 "Could not bind to: " + path);
+    ALWAYS_CHECK(::listen(listener, SOMAXCONN) == 0, "Could not listen on: " + path);
+
+    std::signal(SIGINT, [](int) { stop = 1; });
+    std::signal(SIGTERM, [](int) { stop = 1; });
+
+    std::cout << "Serving catalogue on: " << path << std::endl;
+
+    // First entry is the listener
+    std::vector<pollfd> fds{{listener, POLLIN, 0}};
+
+    while (!stop) {
+        // Timeout to notice signals
+        if (::poll(fds.data(), fds.size(), 1000) <= 0) {
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            if (int fd = ::accept(listener, nullptr, nullptr); fd >= 0) {
+                fds.push_back({fd, POLLIN, 0});
+            }
+        }
+
+        // Requests are handled one at a time hence, cat needs no locking
+        for (std::size_t i = 1; i < fds.size(); i++) {
+            if (!fds[i].revents) {
+                continue;
+            }
+
+            Request req;
+            Response res;
+
+            bool ok = (fds[i].revents & POLLIN) && recv_frame(fds[i].fd, req, peer_timeout);
+
+            if (ok && req.kind == Request::lookup) {
+                if (std::optional env = cat.find(req.key, req.geo)) {
+                    res.found = true;
+                    res.env = std::move(*env);
+                }
+            } else if (ok && req.kind == Request::insert) {
+                for (auto &&[key, env] : req.envs) {
+                    cat.merge(key, std::move(env), opt);
+                }
+                cat.write();
+            }
+
+            if (!ok || !send_frame(fds[i].fd, res)) {
+                // Client disconnected
+                ::close(fds[i].fd);
+                fds.erase(fds.begin() + i--);
+            }
+        }
+    }
+
+    for (auto &&p : fds) {
+        ::close(p.fd);
+    }
+
+    ::unlink(path.c_str());
+
+    std::cout << "Catalogue server stopped" << std::endl;
+}
+
+}  // namespace remote
+
+RemoteCatalogue::RemoteCatalogue(std::string const &path) {
+    //
+    sockaddr_un addr = socket_address(path);
+
+    _fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    ALWAYS_CHECK(_fd >= 0, "Could not create socket");
+
+    if (::connect(_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        ::close(_fd);
+        ALWAYS_CHECK(false, "Could not connect to catalogue server: " + path);
+    }
+}
+
+RemoteCatalogue::~RemoteCatalogue() {
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+remote::Response RemoteCatalogue::request(remote::Request const &req) {
+    remote::Response res;
+
+    ALWAYS_CHECK(send_frame(_fd, req) && recv_frame(_fd, res), "Lost catalogue server");
+
+    return res;
+}
+
+std::optional<Environment> RemoteCatalogue::lookup(DiscreteKey const &key, Geometry const &geo) {
+    //
+    remote::Response res = request({remote::Request::lookup, key, geo, {}});
+
+    if (res.found) {
+        return std::move(res.env);
+    } else {
+        return std::nullopt;
+    }
+}
+
+void RemoteCatalogue::insert(std::vector<std::pair<DiscreteKey, Environment>> &&envs) {
+    request({remote::Request::insert, {}, {}, std::move(envs)});
+}
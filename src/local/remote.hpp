@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cereal/types/utility.hpp"
+#include "cereal/types/vector.hpp"
+#include "config.hpp"
+#include "local/discrete_key.hpp"
+#include "local/environment.hpp"
+#include "local/geometry.hpp"
+#include "utility.hpp"
+
+class Catalogue;
+
+namespace remote {
+
+// Messages between RemoteCatalogue and serve(), sent as frames: a little-endian 64-bit length
+// followed by a portable binary archive.
+struct Request {
+    enum : std::uint8_t { lookup = 0, insert = 1 };
+
+    std::uint8_t kind;
+
+    DiscreteKey key;  // Lookup
+    Geometry geo;     // Lookup
+
+    std::vector<std::pair<DiscreteKey, Environment>> envs;  // Insert
+
+    template <class Archive> void serialize(Archive &ar) { ar(kind, key, geo, envs); }
+};
+
+struct Response {
+    bool found = false;
+    Environment env{};  // Lookup
+
+    template <class Archive> void serialize(Archive &ar) { ar(found, env); }
+};
+
+// Serve requests from any number of RemoteCatalogue clients on the UNIX domain socket at path
+// until SIGINT/SIGTERM, inserts are merged into cat which is written after each insert. The
+// catalogue must be journaled such that writes neither block the loop nor expose partial files.
+// Clients that stall part way through sending a request, or send a malformed or oversized
+// request, are disconnected.
+void serve(Catalogue &cat, options::Mechanism const &opt, std::string const &path);
+
+}  // namespace remote
+
+// Client connection to a catalogue server shared by many processes on the same machine
+class RemoteCatalogue {
+  public:
+    explicit RemoteCatalogue(std::string const &path);
+
+    RemoteCatalogue(RemoteCatalogue const &) = delete;
+    RemoteCatalogue &operator=(RemoteCatalogue const &) = delete;
+
+    ~RemoteCatalogue();
+
+    // Fetch the server's environment equivalent to geo (with delta/permute_onto semantics)
+    std::optional<Environment> lookup(DiscreteKey const &key, Geometry const &geo);
+
+    // Merge environments into the server's catalogue
+    void insert(std::vector<std::pair<DiscreteKey, Environment>> &&envs);
+
+  private:
+    int _fd = -1;
+
+    remote::Response request(remote::Request const &req);
+};
@@ -19,6 +19,7 @@
 #include "riften/thiefpool.hpp"
 #include "sp_search/dimer/dimer.hpp"
 #include "sp_search/find_mech.hpp"
+#include "sp_search/recycle.hpp"
 #include "sp_search/sp_search_base.hpp"
 #include "sp_search/vineyard.hpp"
 #include "stream.hpp"
@@ -40,33 +41,55 @@ struct CommandLineArgs {
 
 STRUCTOPT(CommandLineArgs, config_file);
 
-void update_catalogue(Classify &classify,
+// Search the environments of the atoms in cens for mechanisms and write the catalogue
+void search_catalogue(Classify &classify,
                       Catalogue &cat,
                       Packager &packager,
                       Supercell const &cell,
                       std::unique_ptr<SearchBase> const &finder,
                       std::unique_ptr<PotentialBase> const &ff,
                       options::FindMechanisms const &opt_find,
-                      std::vector<DiscreteKey> &keys,
+                      SaddleCache &saddles,
+                      std::shared_ptr<SearchStats> const &stats,
                       std::vector<Geometry> &geos,
-                      std::vector<Catalogue::pointer> &env) {
+                      std::vector<Catalogue::pointer> &env,
+                      std::vector<Mat3<double>> &rot,
+                      std::vector<std::size_t> const &cens) {
     //
     static riften::Thiefpool pool;
 
-    classify(cell, keys, geos);
-
-    if (std::vector cens = cat.canon_update(keys, geos, env); !cens.empty()) {
+    if (!cens.empty()) {
         //
         std::vector pkgs = packager.pack(cell, cens);
 
+        // Re-converge saddle points of previous states then try the mechanisms of similar
+        // environments, mechanisms already known (e.g. reverse mechanisms) are rediscoveries
+        for (std::size_t i = 0; i < pkgs.size(); i++) {
+            packager.recycle(pkgs[i], saddles.take(cell, cens[i]));
+            packager.seed(pkgs[i], cat.seeds(env[cens[i]], geos[cens[i]]));
+            packager.known(pkgs[i], env[cens[i]], geos[cens[i]], rot[cens[i]]);
+        }
+
         Bar bar(pkgs.size());
 
+        // Lets searches skip mechanisms already found by another package of this batch
+        std::shared_ptr<MechRegistry> registry = nullptr;
+
+        if (packager.shared_frame()) {
+            registry = std::make_shared<MechRegistry>(opt_find.proto);
+        }
+
         for (auto &&pk : pkgs) {
-            pk.f_mechs = pool.enqueue([&, f = finder->clone(), p = ff->clone()]() mutable {
-                auto ret = find_mechanisms(opt_find, pk.subcell, p, f);
-                bar.tick();
-                return ret;
-            });
+            pk.f_mechs = enqueue_mechanisms(pool,
+                                            opt_find,
+                                            pk.subcell,
+                                            pk.starts,
+                                            pk.known,
+                                            ff,
+                                            finder,
+                                            [&bar] { bar.tick(); },
+                                            registry,
+                                            stats);
         }
 
         std::exception_ptr error = nullptr;
@@ -88,12 +111,42 @@ void update_catalogue(Classify &classify,
             std::rethrow_exception(error);
         }
 
-        packager.unpack(std::move(pkgs), geos, env);
+        for (auto &&pk : pkgs) {
+            packager.retain(pk, saddles);
+
+            if (opt_find.reverse) {
+                packager.reverse(pk, classify, cat);
+            }
+        }
+
+        packager.unpack(std::move(pkgs), geos, env, rot);
 
         cat.write();
     }
 }
 
+void update_catalogue(Classify &classify,
+                      Catalogue &cat,
+                      Packager &packager,
+                      Supercell const &cell,
+                      std::unique_ptr<SearchBase> const &finder,
+                      std::unique_ptr<PotentialBase> const &ff,
+                      options::FindMechanisms const &opt_find,
+                      SaddleCache &saddles,
+                      std::shared_ptr<SearchStats> const &stats,
+                      std::vector<DiscreteKey> &keys,
+                      std::vector<Geometry> &geos,
+                      std::vector<Catalogue::pointer> &env,
+                      std::vector<Mat3<double>> &rot) {
+    //
+    std::vector dirty = classify.update(cell, keys, geos);
+
+    std::vector cens = cat.canon_update(keys, geos, env, rot, dirty);
+
+    search_catalogue(
+        classify, cat, packager, cell, finder, ff, opt_find, saddles, stats, geos, env, rot, cens);
+}
+
 int main(int argc, char *argv[]) {
     CommandLineArgs clargs = CommandLineArgs::parse(argc, argv);
 
@@ -116,6 +169,7 @@ int main(int argc, char *argv[]) {
     std::vector<DiscreteKey> keys;
     std::vector<Geometry> geos;
     std::vector<Catalogue::pointer> env;
+    std::vector<Mat3<double>> rot;  // Rotates geos[i] onto env[i]->geo
 
     std::unique_ptr minimise = load_minimiser(config);
 
@@ -138,7 +192,12 @@ int main(int argc, char *argv[]) {
 
     streamer.dump_raw(init, -1);
 
-    update_catalogue(classify, cat, packager, init, finder, ff, opt_find, keys, geos, env);
+    SaddleCache saddles(opt_find);
+
+    auto stats = std::make_shared<SearchStats>();
+
+    update_catalogue(
+        classify, cat, packager, init, finder, ff, opt_find, saddles, stats, keys, geos, env, rot);
 
     SuperCache superbasins{options::SuperCache::load(config), init, env};
 
@@ -158,9 +217,16 @@ int main(int argc, char *argv[]) {
         time += dt;
 
         if (modified_cell) {
-            // Changed basin => Changed state => update geos
-            // TODO: build only geo of mechs atom
-            classify(init, keys, geos);
+            // Changed basin => Changed state => update geos/env of atoms near those that moved.
+            // Basins of a superbasin were counted and searched on their first visit hence, only
+            // refresh the state, environments never seen before are still searched.
+            std::vector dirty = classify.update(init, keys, geos);
+
+            std::vector cens = cat.canon_refresh(keys, geos, env, rot, dirty);
+
+            search_catalogue(classify, cat, packager, init, finder, ff, opt_find, saddles, stats,
+                             geos, env, rot, cens);
+
             streamer.dump_raw(init, -1);
         }
 
@@ -168,7 +234,7 @@ int main(int argc, char *argv[]) {
 
         double E0 = ff->energy(init);
 
-        auto const &m = superbasins.reconstruct(mech).onto(init, geos);
+        auto const &m = superbasins.reconstruct(mech).onto(init, geos, env, rot);
 
         post_recon.activ.view() = init.activ.view();
 
@@ -179,7 +245,8 @@ int main(int argc, char *argv[]) {
         /////////////////////////////////////////////////////////////
 
         try {
-            update_catalogue(classify, cat, packager, init, finder, ff, opt_find, keys, geos, env);
+            update_catalogue(classify, cat, packager, init, finder, ff, opt_find, saddles, stats,
+                             keys, geos, env, rot);
         } catch (std::runtime_error const &error) {
             //
             std::cerr << error.what() << std::endl;
@@ -200,7 +267,8 @@ int main(int argc, char *argv[]) {
 
             streamer.dump_raw(init, -4);
 
-            update_catalogue(classify, cat, packager, init, finder, ff, opt_find, keys, geos, env);
+            update_catalogue(classify, cat, packager, init, finder, ff, opt_find, saddles, stats,
+                             keys, geos, env, rot);
         }
 
         /////////////////////////////////
@@ -216,6 +284,9 @@ int main(int argc, char *argv[]) {
                   << "  t " << dt << ":" << time << "s"                                        //
                   << " dE " << std::abs(E1 - Ef) << "eV"                                       //
                   << " dR " << dR << "A"                                                       //
+                  << " lat " << classify.lattice_hit_rate()                                    //
+                  << " rec " << saddles.hit_rate()                                             //
+                  << " grad " << stats->grads_per_saddle()                                     //
                   << " dM " << m.rel_cap << ':' << m.abs_cap / m.rel_cap - m.abs_cap << '\n';  //
 
         streamer(init, i, time, E0, m.activ_energy, Ef, m.pre_factor);
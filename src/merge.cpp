@@ -0,0 +1,69 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "local/catalogue.hpp"
+#include "local/environment.hpp"
+#include "riften/thiefpool.hpp"
+#include "structopt/app.hpp"
+#include "toml++/toml.h"
+#include "utility.hpp"
+
+// Merge catalogues into catalogue.fname, all must share catalogue.format/.r_env/.delta
+struct CommandLineArgs {
+    std::string config_file;
+    std::vector<std::string> catalogues;
+
+    static CommandLineArgs parse(int argc, char *argv[]) try {
+        return structopt::app("olkmc-merge").parse<CommandLineArgs>(argc, argv);
+    } catch (structopt::exception &e) {
+        std::cout << e.what() << "\n";
+        std::cout << e.help();
+        throw e;
+    }
+};
+
+STRUCTOPT(CommandLineArgs, config_file, catalogues);
+
+int main(int argc, char *argv[]) {
+    CommandLineArgs clargs = CommandLineArgs::parse(argc, argv);
+
+    toml::v2::table config = toml::parse_file(clargs.config_file);
+
+    options::Catalogue opt = options::Catalogue::load(config);
+
+    opt.journal = false;
+    opt.server = "";
+
+    std::vector<Catalogue> cats;
+
+    for (auto &&fname : clargs.catalogues) {
+        ALWAYS_CHECK(std::ifstream(fname).good(), "Could not open: " + fname);
+
+        options::Catalogue in = opt;
+
+        in.fname = fname;
+        in.load_from_disk = true;
+
+        cats.emplace_back(in);
+
+        std::cout << "Loaded " << cats.back().size() << " environments from " << fname << '\n';
+    }
+
+    // Output is written from scratch
+    opt.load_from_disk = false;
+
+    Catalogue cat{opt};
+
+    riften::Thiefpool pool;
+
+    cat.merge(std::move(cats), options::Mechanism::load(config), pool);
+
+    std::cout << "Merged into " << cat.size() << " environments\n";
+
+    cat.write();
+
+    return 0;
+}
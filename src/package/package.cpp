@@ -1,6 +1,8 @@
 
 #include "package/package.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
 
 #include "config.hpp"
@@ -42,6 +44,10 @@ Package Packager::pack_full(Supercell const &cell, std::size_t centre) {
 
     pkg.subcell.centre = centre;
 
+    for (std::size_t i = 0; i < pkg.map.size(); i++) {
+        pkg.map[i] = i;
+    }
+
     return pkg;
 }
 
@@ -112,17 +118,114 @@ std::vector<Package> Packager::pack(Supercell const &cell, std::vector<std::size
     return out;
 }
 
+void Packager::seed(Package &pkg, std::vector<Catalogue::Seed> const &seeds) const {
+    for (auto &&seed : seeds) {
+        VecN<double> disp = VecN<double>::Zero(pkg.subcell.activ.size() * 3);
+
+        bool inside = true;
+
+        for (auto &&[idx, vec] : seed) {
+            if (!pkg.map[idx]) {
+                inside = false;
+                break;
+            }
+            disp.segment<3>(3 * *pkg.map[idx]) = vec;
+        }
+
+        if (inside && !seed.empty()) {
+            pkg.starts.push_back({disp, disp});
+        }
+    }
+}
+
+void Packager::recycle(Package &pkg, std::vector<Saddle> const &saddles) const {
+    for (auto &&saddle : saddles) {
+        VecN<double> disp = VecN<double>::Zero(pkg.subcell.activ.size() * 3);
+        VecN<double> ax = VecN<double>::Zero(pkg.subcell.activ.size() * 3);
+
+        bool inside = true;
+
+        for (std::size_t i = 0; i < saddle.idx.size(); i++) {
+            if (!pkg.map[saddle.idx[i]]) {
+                inside = false;
+                break;
+            }
+            disp.segment<3>(3 * *pkg.map[saddle.idx[i]]) = saddle.disp[i];
+            ax.segment<3>(3 * *pkg.map[saddle.idx[i]]) = saddle.ax[i];
+        }
+
+        if (inside) {
+            pkg.starts.push_back({std::move(disp), std::move(ax), true});
+        }
+    }
+}
+
+void Packager::known(Package &pkg,
+                     Catalogue::pointer env,
+                     Geometry const &geo,
+                     Mat3<double> const &R) const {
+    // Index in subcell of the atom in each mechanism slot
+    std::vector<std::size_t> slots;
+
+    for (std::size_t i = 0; i < geo.size(); i++) {
+        if (geo[i].col.state == Colour::activ) {
+            if (!pkg.map[geo[i].idx]) {
+                return;
+            }
+            slots.push_back(*pkg.map[geo[i].idx]);
+        }
+    }
+
+    // Inverse of the (orthogonal) rotation of geo onto env
+    Mat3<double> Rt = R.transpose();
+
+    for (auto &&mech : env->mechs) {
+        ProtoMech &proto = pkg.known.emplace_back();
+
+        static_cast<MechBase &>(proto) = mech;
+
+        proto.disp = VecN<double>::Zero(pkg.subcell.activ.size() * 3);
+        proto.support = slots;
+
+        for (auto &&elem : mech.disp) {
+            proto.disp.segment<3>(3 * slots[elem.slot]) = Rt * elem.vec.matrix();
+        }
+    }
+}
+
+void Packager::retain(Package const &pkg, SaddleCache &cache) const {
+    // Mapping from Subcell -> Supercell
+    std::vector<std::size_t> fwd_map(pkg.subcell.activ.size());
+
+    for (std::size_t i = 0; i < pkg.map.size(); i++) {
+        if (pkg.map[i]) {
+            fwd_map[*pkg.map[i]] = i;
+        }
+    }
+
+    for (auto &&start : pkg.starts) {
+        if (start.saddle) {
+            cache.record(start.found);
+        }
+    }
+
+    for (auto &&mech : pkg.mechs) {
+        cache.insert(mech, fwd_map);
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
 namespace {
 
-// Returns the absolute and fraction of the mechanisms captured during localisation.
-std::pair<double, double> quality(ProtoMech const &proto, std::vector<Vec3<double>> const &disp) {
+// Returns the absolute and fraction of the mechanisms captured by localisation and thresholding.
+std::pair<double, double> quality(ProtoMech const &proto,
+                                  std::vector<Mechanism::atom_disp> const &disp) {
     double cap = [&] {
         double sum = 0;
 
         for (auto const &elem : disp) {
-            sum += norm_sq(elem);
+            sum += norm_sq(elem.vec);
         }
         return std::sqrt(sum);
     }();
@@ -133,12 +236,15 @@ std::pair<double, double> quality(ProtoMech const &proto, std::vector<Vec3<doubl
 }
 
 // Convert proto-mechanisms to local mechanism, locality determined by reference geometry, rotor and
-// mapping, only active atoms in the geometry have their motion recorded.
+// mapping, only active atoms in the geometry moving further than tol have their motion recorded.
 std::optional<Mechanism> localise(ProtoMech const &proto,
                                   Geometry const &ref,
                                   Mat3<double> const &rotor,
-                                  std::vector<std::optional<std::size_t>> const &map) {
-    std::vector<Vec3<double>> disp;
+                                  std::vector<std::optional<std::size_t>> const &map,
+                                  double tol) {
+    std::vector<Mechanism::atom_disp> disp;
+
+    std::uint32_t slot = 0;
 
     // Rearrange mechanism onto canonical order
     for (std::size_t i = 0; i < ref.size(); i++) {
@@ -153,7 +259,11 @@ std::optional<Mechanism> localise(ProtoMech const &proto,
                     proto.disp[3 * j + 2],
                 };
 
-                disp.emplace_back(rotor * delta.matrix());
+                if (norm(delta) >= tol) {
+                    disp.push_back({slot, rotor * delta.matrix()});
+                }
+
+                ++slot;
             } else {
                 return std::nullopt;
             }
@@ -179,19 +289,22 @@ double l2_similarity(Geometry const &geo, Mat3<double> const &R, Geometry const
 
 void Packager::unpack_full(Package &&pkg,
                            std::vector<Geometry> const &geos,
-                           std::vector<Catalogue::pointer> const &env) {
+                           std::vector<Catalogue::pointer> const &env,
+                           std::vector<Mat3<double>> const &rot) {
     for (auto &&proto : pkg.mechs) {
         // Centre in frame of subcell
         std::size_t centre = proto.find_centre();
 
-        Mat3<double> R = geos[centre].rotor_onto(env[centre]->geo);
+        Mat3<double> const &R = rot[centre];
 
         // Verify centre and env are exceptional match
         if (l2_similarity(geos[centre], R, env[centre]->geo) > _opt.unpack_tol) {
             continue;
         }
 
-        std::vector<Vec3<double>> disp;
+        std::vector<Mechanism::atom_disp> disp;
+
+        std::uint32_t slot = 0;
 
         // Rearrange mechanism onto canonical order
         for (std::size_t i = 0; i < geos[centre].size(); i++) {
@@ -203,7 +316,11 @@ void Packager::unpack_full(Package &&pkg,
                     proto.disp[3 * geos[centre][i].idx + 2],
                 };
 
-                disp.emplace_back(R * delta.matrix());
+                if (norm(delta) >= _opt.mech.disp_tol) {
+                    disp.push_back({slot, R * delta.matrix()});
+                }
+
+                ++slot;
             }
         }
 
@@ -218,7 +335,8 @@ void Packager::unpack_full(Package &&pkg,
 
 void Packager::unpack_unresolved(Package &&pkg,
                                  std::vector<Geometry> const &geos,
-                                 std::vector<Catalogue::pointer> const &env) {
+                                 std::vector<Catalogue::pointer> const &env,
+                                 std::vector<Mat3<double>> const &rot) {
     for (auto &&proto : pkg.mechs) {
         // Centre in frame of subcell
         std::size_t mech_centre = proto.find_centre();
@@ -234,13 +352,15 @@ void Packager::unpack_unresolved(Package &&pkg,
                 ALWAYS_CHECK(false, "Could not find centre in pkg.map");
             }();
 
-            Mat3<double> R = geos[super_centre].rotor_onto(env[super_centre]->geo);
+            Mat3<double> const &R = rot[super_centre];
 
             if (l2_similarity(geos[super_centre], R, env[super_centre]->geo) > _opt.unpack_tol) {
                 continue;
             }
 
-            if (std::optional mech = localise(proto, geos[super_centre], R, pkg.map)) {
+            double const tol = _opt.mech.disp_tol;
+
+            if (std::optional mech = localise(proto, geos[super_centre], R, pkg.map, tol)) {
                 env[super_centre]->try_push_mech(std::move(*mech),
                                                  _opt.mech.energy_abs_tol,
                                                  _opt.mech.energy_frac_tol,
@@ -257,16 +377,85 @@ void Packager::unpack_unresolved(Package &&pkg,
 
 void Packager::unpack(std::vector<Package> &&pkgs,
                       std::vector<Geometry> const &geos,
-                      std::vector<Catalogue::pointer> const &env) {
+                      std::vector<Catalogue::pointer> const &env,
+                      std::vector<Mat3<double>> const &rot) {
     if (_opt.mode == "global") {
         for (auto &&pkg : pkgs) {
-            unpack_full(std::move(pkg), geos, env);
+            unpack_full(std::move(pkg), geos, env, rot);
         }
     } else if (_opt.mode == "local") {
         for (auto &&pkg : pkgs) {
-            unpack_unresolved(std::move(pkg), geos, env);
+            unpack_unresolved(std::move(pkg), geos, env, rot);
         }
     } else {
         throw std::runtime_error("Packaging mode \"" + _opt.mode + "\" invalid");
     }
-}
\ No newline at end of file
+}
+
+void Packager::reverse(Package const &pkg, Classify &classify, Catalogue &cat) const {
+    //
+    if (!shared_frame()) {
+        return;
+    }
+
+    Supercell final = pkg.subcell;
+
+    // Geometries built from the subcell index its atoms directly
+    std::vector<std::optional<std::size_t>> identity(final.activ.size());
+
+    for (std::size_t i = 0; i < identity.size(); i++) {
+        identity[i] = i;
+    }
+
+    // Every final state is classified against one neighbour list of the initial state
+    double max_disp = 0;
+
+    for (auto &&proto : pkg.mechs) {
+        if (proto.rev_pre_factor > 0) {
+            for (std::size_t i = 0; i < final.activ.size(); i++) {
+                max_disp = std::max(max_disp, norm(proto.disp.segment<3>(3 * i)));
+            }
+        }
+    }
+
+    if (max_disp == 0) {
+        return;  // No reverse mechanisms to register
+    }
+
+    classify.anchor(pkg.subcell, max_disp);
+
+    DiscreteKey key;
+    Geometry geo;
+    Mat3<double> R;
+
+    for (auto &&proto : pkg.mechs) {
+        if (proto.rev_pre_factor <= 0) {
+            continue;
+        }
+
+        ProtoMech rev;
+
+        rev.activ_energy = proto.activ_energy - proto.delta_energy;
+        rev.delta_energy = -proto.delta_energy;
+        rev.pre_factor = proto.rev_pre_factor;
+        rev.disp = -proto.disp;
+
+        final.activ.view() = pkg.subcell.activ.view() + proto.disp;
+
+        // Classify the relaxed final minimum, not its drift-corrected image
+        for (std::size_t i = 0; i < final.activ.size(); i++) {
+            final.activ[i].vec += proto.drift;
+        }
+
+        classify.one(final, rev.find_centre(), key, geo);
+
+        Catalogue::pointer env = cat.canon(key, geo, R);
+
+        if (std::optional mech = localise(rev, geo, R, identity, _opt.mech.disp_tol)) {
+            env->try_push_mech(std::move(*mech),
+                               _opt.mech.energy_abs_tol,
+                               _opt.mech.energy_frac_tol,
+                               _opt.mech.r_tol);
+        }
+    }
+}
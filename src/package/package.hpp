@@ -4,7 +4,10 @@
 
 #include "config.hpp"
 #include "local/catalogue.hpp"
+#include "local/classify.hpp"
 #include "local/environment.hpp"
+#include "sp_search/find_mech.hpp"
+#include "sp_search/recycle.hpp"
 #include "supercell.hpp"
 #include "utility.hpp"
 
@@ -35,6 +38,8 @@ class Package {
     Workcell subcell;                             // Cell in which to conduct SPS
     std::future<std::vector<ProtoMech>> f_mechs;  // Future to store resulting mechanisms
     std::vector<ProtoMech> mechs;
+    std::vector<SearchStart> starts;              // Known starting points for searches
+    std::vector<ProtoMech> known;                 // Mechanisms already in the centre's environment
 
   private:
     friend class Packager;
@@ -51,10 +56,37 @@ class Packager {
     // Make a Package centred on each atom in centres
     std::vector<Package> pack(Supercell const &cell, std::vector<std::size_t> centres);
 
-    // Unpack a set of proto-mechanisms (in a package) into the corresponding local environments
+    // Map seeds onto the subcell of pkg, seeds moving atoms outside the active region are dropped
+    void seed(Package &pkg, std::vector<Catalogue::Seed> const &seeds) const;
+
+    // As seed() but for saddle points to re-converge in place
+    void recycle(Package &pkg, std::vector<Saddle> const &saddles) const;
+
+    // Map the mechanisms env already holds onto the subcell of pkg such that searches count them as
+    // rediscoveries, geo must be canonised onto env and R rotate geo onto env->geo.
+    void known(Package &pkg,
+               Catalogue::pointer env,
+               Geometry const &geo,
+               Mat3<double> const &R) const;
+
+    // Register the reverse of each mechanism found by pkg with the environment of its centre in the
+    // final state, classified from the relaxed final configuration. Call before unpack(). No-op in
+    // local mode as the frozen boundary of a subcell would be classified into the environments.
+    void reverse(Package const &pkg, Classify &classify, Catalogue &cat) const;
+
+    // Store the saddle points of the mechanisms pkg found in cache and record the outcome of its
+    // recycled saddle points, call before unpack()
+    void retain(Package const &pkg, SaddleCache &cache) const;
+
+    // True if every package shares the atom indexing of the supercell it was packed from
+    bool shared_frame() const { return _opt.mode == "global"; }
+
+    // Unpack a set of proto-mechanisms (in a package) into the corresponding local environments,
+    // rot[i] must rotate geos[i] onto env[i]->geo as output by Catalogue::canon_update
     void unpack(std::vector<Package> &&pkgs,
                 std::vector<Geometry> const &geos,
-                std::vector<Catalogue::pointer> const &env);
+                std::vector<Catalogue::pointer> const &env,
+                std::vector<Mat3<double>> const &rot);
 
   private:
     options::Packager _opt;
@@ -64,9 +96,11 @@ class Packager {
 
     void unpack_full(Package &&pkgs,
                      std::vector<Geometry> const &geos,
-                     std::vector<Catalogue::pointer> const &env);
+                     std::vector<Catalogue::pointer> const &env,
+                     std::vector<Mat3<double>> const &rot);
 
     void unpack_unresolved(Package &&pkgs,
                            std::vector<Geometry> const &geos,
-                           std::vector<Catalogue::pointer> const &env);
+                           std::vector<Catalogue::pointer> const &env,
+                           std::vector<Mat3<double>> const &rot);
 };
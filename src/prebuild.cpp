@@ -0,0 +1,211 @@
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "local/catalogue.hpp"
+#include "local/classify.hpp"
+#include "local/environment.hpp"
+#include "minimise/minimiser_base.hpp"
+#include "olkmc.hpp"
+#include "package/package.hpp"
+#include "potentials/potential_base.hpp"
+#include "riften/thiefpool.hpp"
+#include "sp_search/find_mech.hpp"
+#include "sp_search/sp_search_base.hpp"
+#include "structopt/app.hpp"
+#include "supercell.hpp"
+#include "utility.hpp"
+
+// Build a catalogue from many structures in one batch of searches, re-running with the same
+// structures resumes an interrupted prebuild.
+struct CommandLineArgs {
+    std::string config_file;
+    std::vector<std::string> structures;
+
+    static CommandLineArgs parse(int argc, char *argv[]) try {
+        return structopt::app("olkmc-prebuild").parse<CommandLineArgs>(argc, argv);
+    } catch (structopt::exception &e) {
+        std::cout << e.what() << "\n";
+        std::cout << e.help();
+        throw e;
+    }
+};
+
+STRUCTOPT(CommandLineArgs, config_file, structures);
+
+// Searches required by one structure
+struct Job {
+    std::string fname;
+    std::vector<Geometry> geos;
+    std::vector<Catalogue::pointer> env;
+    std::vector<Mat3<double>> rot;
+    std::vector<std::size_t> centres;
+    std::vector<Package> pkgs;
+};
+
+int main(int argc, char *argv[]) {
+    CommandLineArgs clargs = CommandLineArgs::parse(argc, argv);
+
+    toml::v2::table config = toml::parse_file(clargs.config_file);
+
+    std::unique_ptr<PotentialBase> ff = load_potential(config);
+
+    std::unique_ptr minimise = load_minimiser(config);
+
+    std::unique_ptr finder = load_sp_search(config);
+
+    Classify classify = load_classifyer(config);
+
+    options::Catalogue opt = options::Catalogue::load(config);
+
+    opt.server = "";            // Prebuild owns the catalogue
+    opt.load_from_disk = true;  // Resume
+
+    Catalogue cat{opt};
+
+    Packager packager(options::Packager::load(config));
+
+    auto opt_find = options::FindMechanisms::load(config);
+
+    // Structures for which every environment has been searched and written
+    std::string const progress = opt.fname + ".prebuild";
+
+    std::set<std::string> done;
+
+    {
+        std::ifstream file(progress);
+
+        for (std::string line; std::getline(file, line);) {
+            done.insert(line);
+        }
+    }
+
+    std::vector<Job> jobs;
+
+    // Environments to search and their number of occurrences, until searched they are kept in the
+    // unsearched state (freq == 0) such that an interrupted prebuild never persists environments
+    // that look searched, they are searched by the next prebuild or olkmc run instead.
+    std::map<Catalogue::pointer, int> pending;
+
+    std::size_t num_pkgs = 0;
+
+    // Classify everything first such that each environment is searched once, globally
+    for (auto &&fname : clargs.structures) {
+        if (done.count(fname)) {
+            std::cout << "Skipping completed: " << fname << '\n';
+            continue;
+        }
+
+        auto [cell, _] = load_supercell(config, ff->species_map(), fname);
+
+        ALWAYS_CHECK(minimise->minimise(cell, ff), "Minimisation failed: " + fname);
+
+        Job &job = jobs.emplace_back();
+
+        job.fname = fname;
+
+        std::vector<DiscreteKey> keys;
+
+        classify(cell, keys, job.geos);
+
+        for (auto &&i : cat.canon_update(keys, job.geos, job.env, job.rot)) {
+            //
+            job.env[i]->freq = 0;
+
+            if (pending[job.env[i]]++ == 0) {
+                job.centres.push_back(i);
+            }
+        }
+
+        job.pkgs = packager.pack(cell, job.centres);
+
+        // Start from the mechanisms of similar environments, those already known are rediscoveries
+        for (std::size_t i = 0; i < job.pkgs.size(); i++) {
+            std::size_t c = job.centres[i];
+            packager.seed(job.pkgs[i], cat.seeds(job.env[c], job.geos[c]));
+            packager.known(job.pkgs[i], job.env[c], job.geos[c], job.rot[c]);
+        }
+
+        num_pkgs += job.pkgs.size();
+
+        std::cout << fname << ": " << job.centres.size() << " new environments\n";
+    }
+
+    riften::Thiefpool pool;
+
+    Bar bar(num_pkgs);
+
+    auto stats = std::make_shared<SearchStats>();
+
+    for (auto &&job : jobs) {
+        // Lets searches skip mechanisms already found by another package of this structure
+        std::shared_ptr<MechRegistry> registry = nullptr;
+
+        if (packager.shared_frame()) {
+            registry = std::make_shared<MechRegistry>(opt_find.proto);
+        }
+
+        for (auto &&pk : job.pkgs) {
+            pk.f_mechs = enqueue_mechanisms(pool,
+                                            opt_find,
+                                            pk.subcell,
+                                            pk.starts,
+                                            pk.known,
+                                            ff,
+                                            finder,
+                                            [&bar] { bar.tick(); },
+                                            registry,
+                                            stats);
+        }
+    }
+
+    std::exception_ptr error = nullptr;
+
+    std::ofstream log(progress, std::ios::app);
+
+    // In order, as later structures may depend on environments claimed by earlier ones
+    for (auto &&job : jobs) {
+        for (auto &&pk : job.pkgs) {
+            if (error) {
+                // Wait for remaining futures
+                pk.f_mechs.wait();
+            } else {
+                try {
+                    pk.mechs = pk.f_mechs.get();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        if (error) {
+            continue;
+        }
+
+        packager.unpack(std::move(job.pkgs), job.geos, job.env, job.rot);
+
+        for (auto &&c : job.centres) {
+            job.env[c]->freq = pending[job.env[c]];
+            job.env[c]->search = 1;
+        }
+
+        cat.write();
+        cat.flush();
+
+        log << job.fname << std::endl;
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    std::cout << "Catalogue holds " << cat.size() << " environments\n";
+    std::cout << "Gradients per saddle point " << stats->grads_per_saddle() << '\n';
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "local/catalogue.hpp"
+#include "local/environment.hpp"
+#include "local/remote.hpp"
+#include "structopt/app.hpp"
+#include "toml++/toml.h"
+#include "utility.hpp"
+
+// Catalogue server shared by olkmc processes on the same machine, listens on catalogue.server
+struct CommandLineArgs {
+    std::string config_file;
+
+    static CommandLineArgs parse(int argc, char *argv[]) try {
+        return structopt::app("olkmc-server").parse<CommandLineArgs>(argc, argv);
+    } catch (structopt::exception &e) {
+        std::cout << e.what() << "\n";
+        std::cout << e.help();
+        throw e;
+    }
+};
+
+STRUCTOPT(CommandLineArgs, config_file);
+
+int main(int argc, char *argv[]) {
+    CommandLineArgs clargs = CommandLineArgs::parse(argc, argv);
+
+    toml::v2::table config = toml::parse_file(clargs.config_file);
+
+    options::Catalogue opt = options::Catalogue::load(config);
+
+    ALWAYS_CHECK(!opt.server.empty(), "catalogue.server must name a socket to serve on");
+
+    // The server owns the catalogue file
+    std::string const path = std::exchange(opt.server, "");
+
+    // Writes go to a background thread and snapshots are replaced atomically, hence clients
+    // loading the file never see it half written and the server never stalls on disk.
+    opt.journal = true;
+
+    Catalogue cat{opt};
+
+    remote::serve(cat, options::Mechanism::load(config), path);
+
+    cat.write();
+
+    return 0;
+}
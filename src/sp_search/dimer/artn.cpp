@@ -0,0 +1,178 @@
+#include "sp_search/dimer/artn.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "Eigen/Eigenvalues"
+#include "toml++/toml.h"
+#include "utility.hpp"
+
+namespace options {
+
+ARTn ARTn::load(toml::v2::table const &config) {
+    ARTn opt;
+
+    opt.n = config["sp_search"]["art"]["n_tran"].value_or(opt.n);
+    opt.n_lanczos = config["sp_search"]["art"]["n_lanczos"].value_or(opt.n_lanczos);
+    opt.n_perp = config["sp_search"]["art"]["n_perp"].value_or(opt.n_perp);
+    opt.iter_max_activ = config["sp_search"]["art"]["iter_max_activ"].value_or(opt.iter_max_activ);
+    opt.iter_max_tran = config["sp_search"]["art"]["iter_max_tran"].value_or(opt.iter_max_tran);
+    opt.convex_max = config["sp_search"]["art"]["convex_max"].value_or(opt.convex_max);
+
+    opt.lanczos_floor = config["sp_search"]["art"]["lanczos_floor"].value_or(opt.lanczos_floor);
+    opt.lanczos_tol = config["sp_search"]["art"]["lanczos_tol"].value_or(opt.lanczos_tol);
+    opt.eig_tol = config["sp_search"]["art"]["eig_tol"].value_or(opt.eig_tol);
+
+    opt.delta_r = fetch<double>(config, "sp_search", "art", "delta_r");
+    opt.push = fetch<double>(config, "sp_search", "art", "push");
+    opt.alpha = fetch<double>(config, "sp_search", "art", "alpha");
+    opt.max_trust = fetch<double>(config, "sp_search", "art", "max_trust");
+    opt.f2norm = fetch<double>(config, "sp_search", "art", "f2norm");
+    opt.nudge = fetch<double>(config, "sp_search", "art", "nudge");
+    opt.basin_tol = fetch<double>(config, "sp_search", "art", "basin_tol");
+
+    ALWAYS_CHECK(opt.n_lanczos > 1, "sp_search.art.n_lanczos must be greater than one");
+
+    return opt;
+}
+
+}  // namespace options
+
+bool ARTn::find_sp(Supercell &cell, VecN<double> &ax, std::unique_ptr<PotentialBase> &ff) {
+    //
+    _core.clear();
+    _grad_calls = 0;
+
+    ax *= 1 / norm(ax);
+
+    _push = ax;
+
+    double curv;
+
+    // Activation, leave the harmonic basin along _push
+    for (std::size_t i = 0;; i++) {
+        if (i == _opt.iter_max_activ) {
+            return false;
+        }
+
+        gradient(cell, _g, ff);
+
+        if ((curv = lanczos(cell, ax, ff)) < _opt.eig_tol) {
+            break;
+        }
+
+        cell.activ.view() += _opt.push * _push;
+
+        for (std::size_t j = 0; j < _opt.n_perp; j++) {
+            gradient(cell, _g, ff);
+
+            _g -= dot(_g, _push) * _push;
+
+            if (double mag = norm(_g); mag > 0) {
+                cell.activ.view() -= std::min(_opt.alpha, _opt.max_trust / mag) * _g;
+            }
+        }
+    }
+
+    std::size_t convex_count = 0;
+
+    // Convergence, _g and ax are up to date with cell
+    for (std::size_t i = 0; i < _opt.iter_max_tran; ++i) {
+        //
+        _geff = _g - 2 * dot(_g, ax) * ax;
+
+        if (dot(_geff, _geff) < _opt.f2norm * _opt.f2norm) {
+            return true;
+        } else if (convex_count >= _opt.convex_max) {
+            return false;
+        }
+
+        _core(cell.activ.view(), _geff, _q);
+
+        cell.activ.view() -= std::min(1.0, _opt.max_trust / norm(_q)) * _q;
+
+        gradient(cell, _g, ff);
+
+        curv = lanczos(cell, ax, ff);
+
+        if (curv > 0) {
+            convex_count += 1;
+        } else {
+            convex_count = 0;
+        }
+    }
+
+    return false;
+}
+
+void ARTn::gradient(Supercell &cell, VecN<double> &out, std::unique_ptr<PotentialBase> &ff) {
+    ff->gradient(cell, out);
+    _grad_calls += 1;
+}
+
+// Find the lowest eigen-mode of the Hessian at cell using ax as the starting vector, requires _g to
+// hold the gradient at cell. On return ax holds the normalised eigen-mode (oriented along the
+// starting vector) and cell is returned as recived. Returns the eigen-value.
+double ARTn::lanczos(Supercell &cell, VecN<double> &ax, std::unique_ptr<PotentialBase> &ff) {
+    //
+    static thread_local Eigen::SelfAdjointEigenSolver<MatN<double>> es;
+
+    std::size_t m = std::min<std::size_t>(_opt.n_lanczos, ax.size());
+
+    _x = cell.activ.view();
+    _tri = MatN<double>::Zero(m, m);
+    _basis.resize(m);
+
+    _basis[0] = ax / norm(ax);
+
+    double eig = 0;
+    std::size_t k = 0;
+
+    for (;; k++) {
+        // Forward-difference Hessian-vector product
+        cell.activ.view() = _x + _opt.delta_r * _basis[k];
+        gradient(cell, _hv, ff);
+        _hv = (_hv - _g) / _opt.delta_r;
+
+        _tri(k, k) = dot(_hv, _basis[k]);
+
+        // Full re-orthogonalisation, subsumes the three-term recurrence
+        for (std::size_t j = 0; j <= k; j++) {
+            _hv -= dot(_hv, _basis[j]) * _basis[j];
+        }
+
+        es.compute(_tri.topLeftCorner(k + 1, k + 1));
+
+        double prev = std::exchange(eig, es.eigenvalues()[0]);
+
+        double beta = norm(_hv);
+
+        // The floor stops near-zero curvatures, e.g. close to an inflection, never converging
+        double tol = std::max(_opt.lanczos_floor, _opt.lanczos_tol * std::abs(eig));
+
+        if ((k > 0 && std::abs(eig - prev) < tol) || k + 1 == m || beta < 1e-10) {
+            break;
+        }
+
+        _tri(k, k + 1) = beta;
+        _tri(k + 1, k) = beta;
+
+        _basis[k + 1] = _hv / beta;
+    }
+
+    cell.activ.view() = _x;
+
+    auto y = es.eigenvectors().col(0);
+
+    ax = (y[0] < 0 ? -y[0] : y[0]) * _basis[0];
+
+    for (std::size_t j = 1; j <= k; j++) {
+        ax += (y[0] < 0 ? -y[j] : y[j]) * _basis[j];
+    }
+
+    ax *= 1 / norm(ax);
+
+    return eig;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "config.hpp"
+#include "minimise/LBFGS/core.hpp"
+#include "potentials/potential_base.hpp"
+#include "supercell.hpp"
+#include "toml++/toml.h"
+#include "utility.hpp"
+
+namespace options {
+
+struct ARTn {
+    std::size_t n = 10;                // Number of previous steps held in memory
+    std::size_t n_lanczos = 16;        // Maximum number of Lanczos iterations per eigen-mode
+    std::size_t n_perp = 4;            // Perpendicular relaxation steps per activation step
+    std::size_t iter_max_activ = 50;   // Number of activation steps before exit
+    std::size_t iter_max_tran = 1000;  // Number of convergence steps before exit
+    std::size_t convex_max = 5;        // Number of consecutive +Ve curvature steps before exit
+
+    double lanczos_tol = 0.01;    // Relative change in eigen-value for Lanczos to be converged
+    double lanczos_floor = 1e-3;  // (eV/Angstrom^2) Change always small enough to be converged
+    double eig_tol = -0.01;       // (eV/Angstrom^2) Activation ends once curvature is below this
+
+    double delta_r;    // (Angstroms) Finite difference step of Hessian-vector products
+    double push;       // (Angstroms) Activation step along the initial direction
+    double alpha;      // (Angstroms^2/eV) Steepest-descent step of perpendicular relaxation
+    double max_trust;  // (Angstroms) Maximum step size
+    double f2norm;     // Force convergence criterion (eV/Angstroms)
+
+    double nudge;      // (Angstroms) Distance perturbed along min-mode at SP
+    double basin_tol;  // (Angstroms) L2 between active atoms to be considered distinct basins
+
+    static ARTn load(toml::v2::table const &config);
+};
+
+}  // namespace options
+
+// Class responsible for moving a cell+axis to a near-by saddle-point in the style of ART nouveau.
+// The lowest eigen-mode is found with Lanczos iterations on finite-difference Hessian-vector
+// products, each costing a single gradient. During activation the cell is pushed along the initial
+// axis, relaxing perpendicular to it, until the lowest curvature is below eig_tol. Convergence then
+// follows the lowest eigen-mode with LBFGS on the inverted gradient, as in the Dimer.
+class ARTn {
+  public:
+    ARTn(options::ARTn const &opt) : _opt(opt), _core(opt.n) {}
+
+    bool find_sp(Supercell &cell, VecN<double> &ax, std::unique_ptr<PotentialBase> &ff);
+
+    options::ARTn const &get_opt() const { return _opt; }
+
+    // Number of gradient evaluations used by the last call to find_sp()
+    std::size_t grad_calls() const { return _grad_calls; }
+
+  private:
+    options::ARTn _opt;
+
+    CoreLBFGS _core;
+
+    std::size_t _grad_calls = 0;
+
+    VecN<double> _push;  // Activation direction
+    VecN<double> _x;     // Active atoms
+    VecN<double> _g;     // Gradient at the active atoms
+    VecN<double> _hv;    // Hessian-vector product
+    VecN<double> _q;     // Newton step
+    VecN<double> _geff;  // Effective gradient
+
+    MatN<double> _tri;                 // Lanczos tri-diagonal matrix
+    std::vector<VecN<double>> _basis;  // Lanczos vectors
+
+    void gradient(Supercell &cell, VecN<double> &out, std::unique_ptr<PotentialBase> &ff);
+
+    double lanczos(Supercell &cell, VecN<double> &ax, std::unique_ptr<PotentialBase> &ff);
+};
@@ -35,6 +35,8 @@ Dimer Dimer::load(toml::v2::table const &config) {
     opt.proj_tol = config["sp_search"]["dimer"]["proj_tol"].value_or(opt.proj_tol);
     opt.grow_trust = config["sp_search"]["dimer"]["grow_trust"].value_or(opt.grow_trust);
     opt.shrink_trust = config["sp_search"]["dimer"]["shrink_trust"].value_or(opt.shrink_trust);
+    opt.skip_rot_tol = config["sp_search"]["dimer"]["skip_rot_tol"].value_or(opt.skip_rot_tol);
+    opt.max_skip_rot = config["sp_search"]["dimer"]["max_skip_rot"].value_or(opt.max_skip_rot);
 
     opt.f2norm = fetch<double>(config, "sp_search", "dimer", "f2norm");
     opt.nudge = fetch<double>(config, "sp_search", "dimer", "nudge");
@@ -60,6 +62,8 @@ double DimerRotor::align(Supercell &cell, VecN<double> &ax, std::unique_ptr<Pote
     cell.activ.view() = _active + _opt.delta_r * ax;
     ff->gradient(cell, _g1);
 
+    _grad_calls += 2;
+
     for (size_t i = 0;; i++) {
         _delta_g = _g1 - _g0;
         _delta_g -= dot(_delta_g, ax) * ax;  // Torque
@@ -82,6 +86,8 @@ double DimerRotor::align(Supercell &cell, VecN<double> &ax, std::unique_ptr<Pote
             cell.activ.view() = _active + _opt.delta_r * _axisp;
             ff->gradient(cell, _g1p);
 
+            _grad_calls += 1;
+
             double c_x1 = dot(_g1p - _g0, _axisp) / _opt.delta_r;
             double a_1 = (c_x0 - c_x1 + b_1 * sin(2 * theta_1)) / (1 - std::cos(2 * theta_1));
             double theta_min = 0.5 * std::atan(b_1 / a_1);  // Optimal rotation
@@ -108,10 +114,33 @@ double DimerRotor::align(Supercell &cell, VecN<double> &ax, std::unique_ptr<Pote
     }
 }
 
+// Instead of aligning, compute the gradient at the centre of the dimer and extrapolate the gradient
+// at the end by assuming the dimer translated rigidly since the last call to align()/extrapolate(),
+// hence the returned curvature is that of the last call. Costs a single gradient evaluation.
+double DimerRotor::extrapolate(Supercell &cell,
+                               VecN<double> const &ax,
+                               std::unique_ptr<PotentialBase> &ff) {
+    //
+    _g1 -= _g0;
+
+    ff->gradient(cell, _g0);
+
+    _g1 += _g0;
+
+    _grad_calls += 1;
+
+    return dot(_g1 - _g0, ax) / _opt.delta_r;
+}
+
 bool Dimer::find_sp(Supercell &cell, VecN<double> &ax, std::unique_ptr<PotentialBase> &ff) {
     // Uses LBFGS loop with modified curvature escape clauses
 
     _core.clear();
+    _rotor.reset_grad_calls();
+
+    _curv_rot = 0;
+    _may_skip = false;
+    _skipped = 0;
 
     double curv = eff_grad(cell, ax, ff);
 
@@ -127,7 +156,12 @@ bool Dimer::find_sp(Supercell &cell, VecN<double> &ax, std::unique_ptr<Potential
         //           << '\n';
 
         if (dot(_geff, _geff) < _opt.f2norm * _opt.f2norm) {
-            return true;
+            if (_skipped == 0) {
+                return true;
+            }
+            // Converged along a stale axis, rotate before accepting
+            curv = eff_grad(cell, ax, ff, true);
+            continue;
         } else if (convex_count >= _opt.convex_max) {
             return false;
         }
@@ -157,11 +191,28 @@ bool Dimer::find_sp(Supercell &cell, VecN<double> &ax, std::unique_ptr<Potential
     return false;
 }
 
-// Transform the gradient at the centre into the modified gradient
-double Dimer::eff_grad(Supercell &cell, VecN<double> &ax, std::unique_ptr<PotentialBase> &ff) {
+// Transform the gradient at the centre into the modified gradient, rotations are skipped while the
+// curvature is stable unless force_rot is true. A change in the sign of the curvature between
+// rotations always forces the next translation to rotate.
+double Dimer::eff_grad(Supercell &cell,
+                       VecN<double> &ax,
+                       std::unique_ptr<PotentialBase> &ff,
+                       bool force_rot) {
     //
+    double curv;
 
-    double curv = _rotor.align(cell, ax, ff);  // cell.activ is overwritten
+    if (!force_rot && _may_skip && _skipped < _opt.max_skip_rot) {
+        curv = _rotor.extrapolate(cell, ax, ff);
+        _skipped += 1;
+    } else {
+        curv = _rotor.align(cell, ax, ff);  // cell.activ is overwritten
+
+        _may_skip = _opt.skip_rot_tol > 0 && curv * _curv_rot > 0
+                    && std::abs(curv - _curv_rot) < _opt.skip_rot_tol * std::abs(_curv_rot);
+
+        _curv_rot = curv;
+        _skipped = 0;
+    }
 
     double mag = norm(_rotor.grad());
 
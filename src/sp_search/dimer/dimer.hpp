@@ -42,6 +42,13 @@ struct Dimer {
     double grow_trust = 1.5;    // Trust radius expansion rate
     double shrink_trust = 0.5;  // Trust radius contraction rate
 
+    // If positive, rotations are skipped while the curvature changes (relative) by less than this
+    // between successive rotations, at most max_skip_rot translations in a row are made without one.
+    // Skipped steps reuse the curvature of the last rotation hence, a change of sign while skipping
+    // is only detected by the next rotation, at most max_skip_rot translations later.
+    double skip_rot_tol = 0;
+    std::size_t max_skip_rot = 5;
+
     double f2norm;     // Force convergence criterion (eV/Angstroms)
     double nudge;      // (Angstroms) Distance perturbed along min-mode at SP
     double basin_tol;  // (Angstroms) L2 between active atoms to be considered distinct basins
@@ -60,11 +67,20 @@ class DimerRotor {
 
     double align(Supercell &cell, VecN<double> &ax, std::unique_ptr<PotentialBase> &ff);
 
+    double extrapolate(Supercell &cell, VecN<double> const &ax, std::unique_ptr<PotentialBase> &ff);
+
     VecN<double> const &grad() const { return _g0; }
 
+    // Number of gradient evaluations since the last call to reset_grad_calls()
+    std::size_t grad_calls() const { return _grad_calls; }
+
+    void reset_grad_calls() { _grad_calls = 0; }
+
   private:
     options::DimerRotor _opt;
 
+    std::size_t _grad_calls = 0;
+
     CoreLBFGS _core;
 
     VecN<double> _active;  // Store active atoms
@@ -85,6 +101,9 @@ class Dimer {
 
     options::Dimer const &get_opt() const { return _opt; }
 
+    // Number of gradient evaluations used by the last call to find_sp()
+    std::size_t grad_calls() const { return _rotor.grad_calls(); }
+
   private:
     options::Dimer _opt;
 
@@ -95,5 +114,12 @@ class Dimer {
     VecN<double> _q;     // Newton step
     VecN<double> _geff;  // Effective gradient
 
-    double eff_grad(Supercell &cell, VecN<double> &ax, std::unique_ptr<PotentialBase> &ff);
+    double _curv_rot;      // Curvature at the last rotation
+    bool _may_skip;        // True if the last two rotations found similar curvatures
+    std::size_t _skipped;  // Number of translations since the last rotation
+
+    double eff_grad(Supercell &cell,
+                    VecN<double> &ax,
+                    std::unique_ptr<PotentialBase> &ff,
+                    bool force_rot = false);
 };
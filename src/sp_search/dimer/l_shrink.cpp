@@ -30,6 +30,8 @@ bool LShrink::find_sp(Supercell &cell, VecN<double> &v, std::unique_ptr<Potentia
     _x.resize(2 * n);
     _gx.resize(2 * n);
 
+    _grad_calls = 0;
+
     _x.head(n) = cell.activ.view();
     _x.tail(n) = v;
 
@@ -41,6 +43,8 @@ bool LShrink::find_sp(Supercell &cell, VecN<double> &v, std::unique_ptr<Potentia
         cell.activ.view() = _x.head(n) - (0.5 * _opt.l0) * _x.tail(n);
         ff->gradient(cell, _G2);
 
+        _grad_calls += 2;
+
         // Compute d_k
         _gx.tail(n) = (1 / _opt.l0) * (_G1 - _G2);
         _gx.tail(n) -= dot(_gx.tail(n), _x.tail(n)) * _x.tail(n);  // Perpendiularise
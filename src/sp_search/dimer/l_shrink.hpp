@@ -43,9 +43,14 @@ class LShrink {
 
     options::LShrink const &get_opt() const { return _opt; }
 
+    // Number of gradient evaluations used by the last call to find_sp()
+    std::size_t grad_calls() const { return _grad_calls; }
+
   private:
     options::LShrink _opt;
 
+    std::size_t _grad_calls = 0;
+
     CoreLBFGS _core;
 
     VecN<double> _x;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <random>
 
@@ -22,6 +23,16 @@ template <typename T> class DimerSPS final : public SearchBase {
                  Supercell& final,
                  std::unique_ptr<PotentialBase>& ff) override;
 
+    bool find_sp_along(Supercell const& init,
+                       Supercell& dimer,
+                       VecN<double> const& ax,
+                       Supercell& final,
+                       std::unique_ptr<PotentialBase>& ff) override;
+
+    VecN<double> axis() const override { return _ax; }
+
+    std::size_t grad_calls() const override { return _dimer.grad_calls(); }
+
   private:
     T _dimer;
     std::unique_ptr<MinimiserBase> _minimiser;
@@ -32,6 +43,13 @@ template <typename T> class DimerSPS final : public SearchBase {
     VecN<double> _ax;
 
     Supercell _old;
+
+    // Search from dimer along _ax, shared by find_sp and find_sp_along
+    bool search(Supercell const& init,
+                Supercell& dimer,
+                Supercell& final,
+                std::unique_ptr<PotentialBase>& ff);
+
     // DimerRotor _rotor{{6, 1000, 0.01, 0.0001}};
 };
 
@@ -64,8 +82,25 @@ template <typename T> bool DimerSPS<T>::find_sp(Supercell const& init,
 
     _ax *= 1 / norm(_ax);
 
-    //////////////////////////////////////////////
+    return search(init, dimer, final, ff);
+}
+
+template <typename T> bool DimerSPS<T>::find_sp_along(Supercell const& init,
+                                                      Supercell& dimer,
+                                                      VecN<double> const& ax,
+                                                      Supercell& final,
+                                                      std::unique_ptr<PotentialBase>& ff) {
+    _ax = ax;
+
+    _ax *= 1 / norm(_ax);
+
+    return search(init, dimer, final, ff);
+}
 
+template <typename T> bool DimerSPS<T>::search(Supercell const& init,
+                                               Supercell& dimer,
+                                               Supercell& final,
+                                               std::unique_ptr<PotentialBase>& ff) {
     // Do SPS
     if (!_dimer.find_sp(dimer, _ax, ff)) {
         return false;
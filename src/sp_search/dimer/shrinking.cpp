@@ -31,6 +31,8 @@ bool ShrinkingDimer::find_sp(Supercell &cell, VecN<double> &v, std::unique_ptr<P
 
     _x = cell.activ.view();
 
+    _grad_calls = 0;
+
     for (size_t i = 0; i < _opt.iter_max_tran; i++) {
         // Compute gradients at end points of dimer
         cell.activ.view() = _x + (0.5 * l) * v;
@@ -39,6 +41,8 @@ bool ShrinkingDimer::find_sp(Supercell &cell, VecN<double> &v, std::unique_ptr<P
         cell.activ.view() = _x - (0.5 * l) * v;
         ff->gradient(cell, _G2);
 
+        _grad_calls += 2;
+
         using std::swap;
         // Compute d_k (torque)
         swap(_d_p, _d);
@@ -43,9 +43,14 @@ class ShrinkingDimer {
 
     options::ShrinkingDimer const &get_opt() const { return _opt; }
 
+    // Number of gradient evaluations used by the last call to find_sp()
+    std::size_t grad_calls() const { return _grad_calls; }
+
   private:
     options::ShrinkingDimer _opt;
 
+    std::size_t _grad_calls = 0;
+
     VecN<double> _x;
 
     VecN<double> _G1;
@@ -4,6 +4,8 @@
 #include <cmath>
 #include <cstddef>
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <stdexcept>
 
@@ -21,14 +23,31 @@ FindMechanisms FindMechanisms::load(toml::v2::table const& config) {
 
     opt.consecutive = config["sp_search"]["consecutive"].value_or(opt.consecutive);
     opt.max_search = config["sp_search"]["max_search"].value_or(opt.max_search);
+    opt.batch = config["sp_search"]["batch"].value_or(opt.batch);
     opt.vineyard = config["sp_search"]["vineyard"].value_or(opt.vineyard);
     opt.vine_zero_tol = config["sp_search"]["vine_zero_tol"].value_or(opt.vine_zero_tol);
+    opt.seed_frac = config["sp_search"]["seed_frac"].value_or(opt.seed_frac);
+    opt.recycle = config["sp_search"]["recycle"].value_or(opt.recycle);
+    opt.r_recycle = config["sp_search"]["r_recycle"].value_or(opt.r_recycle);
+    opt.reverse = config["sp_search"]["reverse"].value_or(opt.reverse);
+    opt.miss_frac = config["sp_search"]["miss_frac"].value_or(opt.miss_frac);
+    opt.sampling = config["sp_search"]["sampling"].value_or(opt.sampling);
+    opt.repulsion = config["sp_search"]["repulsion"].value_or(opt.repulsion);
+
+    ALWAYS_CHECK(opt.sampling == "random" || opt.sampling == "halton",
+                 "sp_search.sampling must be \"random\" or \"halton\"");
+
+    if (opt.miss_frac > 0) {
+        opt.temp = fetch<double>(config, "kinetics", "temperature");
+    }
 
     opt.r_perturbation = fetch<double>(config, "sp_search", "r_perturbation");
     opt.stddev = fetch<double>(config, "sp_search", "stddev");
 
     opt.proto = Mechanism::load(config);
 
+    ALWAYS_CHECK(opt.batch > 0, "sp_search.batch must be positive");
+
     if (!opt.vineyard) {
         opt.const_pre_factor = fetch<double>(config, "sp_search", "const_pre_factor");
     }
@@ -38,6 +57,36 @@ FindMechanisms FindMechanisms::load(toml::v2::table const& config) {
 
 }  // namespace options
 
+bool MechRegistry::contains(std::size_t centre, ProtoMech const& mech) const {
+    if (auto it = _mechs.find(centre); it != _mechs.end()) {
+        return std::any_of(it->second.begin(), it->second.end(), [&](ProtoMech const& other) {
+            return mech.within_tol(
+                other, _opt.energy_abs_tol, _opt.energy_frac_tol, _opt.r_tol, _opt.disp_tol);
+        });
+    }
+    return false;
+}
+
+bool MechRegistry::contains(ProtoMech const& mech) const {
+    std::size_t centre = mech.find_centre();
+    std::lock_guard lock(_mut);
+    return contains(centre, mech);
+}
+
+bool MechRegistry::try_insert(ProtoMech const& mech) {
+    std::size_t centre = mech.find_centre();
+
+    std::lock_guard lock(_mut);
+
+    if (contains(centre, mech)) {
+        return false;
+    }
+
+    _mechs[centre].push_back(mech);
+
+    return true;
+}
+
 namespace {
 
 void random_local_pertubation(std::size_t n, Supercell& dimer, double range, double stddev) {
@@ -80,6 +129,69 @@ void random_local_pertubation(std::size_t n, Supercell& dimer, double range, dou
     return;
 }
 
+// Radical inverse of i in base, the ith element of a Halton sequence
+double radical_inverse(std::size_t i, std::size_t base) {
+    double inv = 1.0 / base;
+    double f = inv;
+    double r = 0;
+
+    for (; i > 0; i /= base, f *= inv) {
+        r += f * (i % base);
+    }
+
+    return r;
+}
+
+// As random_local_pertubation but the direction each atom moves in the kth search of a cell is
+// the kth point of a Halton sequence (bases 2, 3) mapped onto the unit sphere. Each atom's sequence
+// is shifted (modulo 1) along a Kronecker sequence started at (shift_u, shift_v), two independent
+// random offsets, such that atoms and cells are decorrelated while successive searches remain
+// evenly spread over direction space.
+void halton_local_pertubation(std::size_t n,
+                              Supercell& dimer,
+                              double range,
+                              double stddev,
+                              std::size_t k,
+                              double shift_u,
+                              double shift_v) {
+    // Seed with a real random value, if available
+    static thread_local pcg64 rng(pcg_extras::seed_seq_from<std::random_device>{});
+
+    static thread_local std::normal_distribution<> mag_dist(1, 1);
+
+    static thread_local std::normal_distribution<> guassian(0, stddev);
+
+    Vec3<double> centre = dimer.activ[n].vec;
+
+    double mag = mag_dist(rng);
+
+    double u0 = radical_inverse(k + 1, 2);
+    double v0 = radical_inverse(k + 1, 3);
+
+    for (std::size_t i = 0; i < dimer.activ.size() * 3; i += 3) {
+        //
+        Vec3<double> delta = dimer.min_image(dimer.activ[i / 3].vec, centre);
+
+        if (norm_sq(delta) > range * range) {
+            continue;
+        }
+
+        // Additive recurrences with the plastic number, Kronecker sequence in 2D
+        double u = u0 + shift_u + 0.7548776662466927 * (i / 3);
+        double v = v0 + shift_v + 0.5698402909980532 * (i / 3);
+
+        double z = 1 - 2 * (u - std::floor(u));
+        double phi = 2 * M_PI * (v - std::floor(v));
+        double rho = std::sqrt(1 - z * z);
+
+        Vec3<double> dr = {rho * std::cos(phi), rho * std::sin(phi), z};
+
+        double cut = std::exp(-norm_sq(delta) / (range * range));
+
+        dimer.activ.view().segment<3>(i) += mag * cut * std::abs(guassian(rng)) * dr;
+    }
+}
+
 // Compute change in active atoms positions, attempts to correct for com drift
 VecN<double> mech_disp(Supercell const& xi, Supercell const& xf) {
     CHECK(xi.activ.size() == xf.activ.size(), "Number of atoms are different");
@@ -135,73 +247,405 @@ VecN<double> mech_disp(Supercell const& xi, Supercell const& xf) {
     return dr;
 }
 
-}  // namespace
+// Harmonic prefactor of the reverse of a mechanism, vine must have its saddle point loaded
+double reverse_pre_factor(Vineyard vine,
+                          Supercell const& final,
+                          std::unique_ptr<PotentialBase>& ff) {
+    vine.load_basin(final, ff);
+    return vine.pre_factor();
+}
 
-std::vector<ProtoMech> find_mechanisms(options::FindMechanisms const& opt,
-                                       Workcell const& init,
-                                       std::unique_ptr<PotentialBase>& ff,
-                                       std::unique_ptr<SearchBase>& finder) {
-    // New mechs stored here
-    std::vector<ProtoMech> mechs;
+// Mechanisms found around one cell, shared by every batch of searches working on it
+class SharedSearch {
+  public:
+    SharedSearch(options::FindMechanisms const& opt,
+                 Workcell const& init,
+                 std::vector<SearchStart>& starts,
+                 std::vector<ProtoMech> const& known,
+                 std::size_t batches,
+                 std::function<void()> on_done,
+                 std::shared_ptr<MechRegistry> registry,
+                 std::shared_ptr<SearchStats> stats)
+        : _opt(opt),
+          _init(init),
+          _starts(starts),
+          _known(known),
+          _registry(std::move(registry)),
+          _stats(std::move(stats)),
+          _vine(opt.vine_zero_tol),
+          _hits(known.size(), 0),
+          _batches(batches),
+          _on_done(std::move(on_done)) {
+        static thread_local pcg64 rng(pcg_extras::seed_seq_from<std::random_device>{});
+
+        _shift_u = std::uniform_real_distribution<>{}(rng);
+        _shift_v = std::uniform_real_distribution<>{}(rng);
+    }
+
+    // Run up to num searches, returns early once the stopping rule is satisfied
+    void run(std::size_t num,
+             std::unique_ptr<PotentialBase>& ff,
+             std::unique_ptr<SearchBase>& finder);
+
+    // Called once by each batch when it exits, the last one to exit fulfils the future
+    void finish(std::exception_ptr err);
+
+    std::future<std::vector<ProtoMech>> get_future() { return _promise.get_future(); }
+
+  private:
+    options::FindMechanisms _opt;
+    Workcell const& _init;
+    std::vector<SearchStart>& _starts;  // Each element is only touched by the batch that claims it
+    std::vector<ProtoMech> const& _known;
+
+    std::shared_ptr<MechRegistry> _registry;  // Optional, shared with other cells
+    std::shared_ptr<SearchStats> _stats;      // Optional, shared with other cells
+
+    double _shift_u;  // Random start of the Halton sequences of this cell (polar)
+    double _shift_v;  // Random start of the Halton sequences of this cell (azimuthal)
+
+    std::once_flag _basin;
+    Vineyard _vine;  // Basin loaded once then copied by each batch
+
+    std::mutex _mut;  // Guards everything below
+    std::vector<ProtoMech> _mechs;
+    std::vector<std::size_t> _hits;  // Times each of _known then _mechs has been found
+
+    std::size_t _started = 0;  // Searches claimed from the max_search budget
+    std::size_t _claimed = 0;  // Starts claimed
+    std::size_t _count = 0;    // Consecutive failure/mech rediscoveries, in order of completion
+    std::size_t _batches;      // Batches yet to finish
+    std::exception_ptr _error = nullptr;
+
+    std::promise<std::vector<ProtoMech>> _promise;
+    std::function<void()> _on_done;
+
+    // Requires _mut to be held, index into _hits of the mechanism equivalent to mech
+    std::optional<std::size_t> match(ProtoMech const& mech) const {
+        auto same = [&](ProtoMech const& other) {
+            return mech.within_tol(other,
+                                   _opt.proto.energy_abs_tol,
+                                   _opt.proto.energy_frac_tol,
+                                   _opt.proto.r_tol,
+                                   _opt.proto.disp_tol);
+        };
+
+        if (auto it = std::find_if(_known.begin(), _known.end(), same); it != _known.end()) {
+            return it - _known.begin();
+        }
+
+        if (auto it = std::find_if(_mechs.begin(), _mechs.end(), same); it != _mechs.end()) {
+            return _known.size() + (it - _mechs.begin());
+        }
+
+        return std::nullopt;
+    }
+
+    // Requires _mut to be held
+    bool is_new(ProtoMech const& mech) const {
+        return !match(mech) && !(_registry && _registry->contains(mech));
+    }
+
+    // Requires _mut to be held, count a search that failed or rediscovered mech
+    void rediscovered(ProtoMech const* mech) {
+        if (mech) {
+            if (std::optional m = match(*mech)) {
+                ++_hits[*m];
+            }
+        }
+        ++_count;
+    }
+
+    // Requires _mut to be held
+    bool done() const;
+
+    // Requires _mut to be held, remove .repulsion of the component of the perturbation of dimer
+    // along each mechanism found or known that it points toward.
+    void repel(Supercell& dimer) const;
+
+    // Requires _mut to be held, estimate of the fraction of the escape rate in unfound mechanisms
+    double missing() const;
+};
+
+double SharedSearch::missing() const {
     //
-    Supercell dimer = init;
-    Supercell final = init;
+    double f1 = 0;     // Mechanisms found exactly once
+    double f2 = 0;     // Mechanisms found exactly twice
+    double rate = 0;   // Of all mechanisms found or known
+    double rate1 = 0;  // Of mechanisms found exactly once
 
-    std::size_t count = 0;  // count consecutive failure/mech rediscoveries
+    for (std::size_t i = 0; i < _hits.size(); i++) {
+        MechBase const& m = i < _known.size() ? _known[i] : _mechs[i - _known.size()];
 
-    Vineyard vine(opt.vine_zero_tol);  // for computing harmonic prefactor
+        double k = m.pre_factor * std::exp(-m.activ_energy * INV_BOLTZ / _opt.temp);
 
-    // Vineyard vine2(opt.vine_zero_tol);
+        rate += k;
 
-    if (opt.vineyard) {
-        vine.load_basin(init, ff);
+        if (_hits[i] == 1) {
+            f1 += 1;
+            rate1 += k;
+        } else if (_hits[i] == 2) {
+            f2 += 1;
+        }
     }
 
-    for (std::size_t i = 0; count < opt.consecutive; i++) {
-        if (i >= opt.max_search) {
-            // std::cout << "WARNING: find_mechanisms hit max_search, consider increasing it\n";
-            break;
+    if (f1 == 0) {
+        return 0;
+    }
+
+    // Chao1 number of unfound mechanisms, f1^2 / 2f2, each at the mean rate of the singletons
+    double miss = f1 / (2 * std::max(f2, 1.0)) * rate1;
+
+    return miss / (rate + miss);
+}
+
+void SharedSearch::repel(Supercell& dimer) const {
+    //
+    VecN<double> dr = dimer.activ.view() - _init.activ.view();
+
+    auto away = [&](ProtoMech const& m) {
+        if (double norm_sq = dot(m.disp, m.disp); norm_sq > 0) {
+            if (double proj = dot(dr, m.disp) / norm_sq; proj > 0) {
+                dr -= _opt.repulsion * proj * m.disp;
+            }
         }
+    };
+
+    std::for_each(_known.begin(), _known.end(), away);
+    std::for_each(_mechs.begin(), _mechs.end(), away);
+
+    dimer.activ.view() = _init.activ.view() + dr;
+}
+
+bool SharedSearch::done() const {
+    // Without a rediscovery count there is nothing to estimate from
+    bool sampled = std::any_of(_hits.begin(), _hits.end(), [](std::size_t h) { return h > 0; });
+
+    // Consecutive rule still applies, noisy singleton counts can hold the estimate up indefinitely
+    if (_opt.miss_frac > 0 && sampled) {
+        return missing() < _opt.miss_frac || _count >= _opt.consecutive;
+    }
 
-        dimer = init;
+    return _count >= _opt.consecutive;
+}
+
+void SharedSearch::run(std::size_t num,
+                       std::unique_ptr<PotentialBase>& ff,
+                       std::unique_ptr<SearchBase>& finder) {
+    if (_opt.vineyard) {
+        std::call_once(_basin, [&] { _vine.load_basin(_init, ff); });
+    }
 
-        random_local_pertubation(init.centre, dimer, opt.r_perturbation, opt.stddev);
+    Vineyard vine = _vine;  // for computing harmonic prefactor
+
+    Supercell dimer = _init;
+    Supercell final = _init;
+
+    for (std::size_t i = 0; i < num; i++) {
+        //
+        SearchStart* start = nullptr;
 
-        count++;
+        std::size_t k = 0;  // Index of this search in the cell's Halton sequence
+
+        {
+            std::lock_guard lock(_mut);
+
+            if (_error || done()) {
+                return;
+            }
+
+            if (_started >= _opt.max_search) {
+                // std::cout << "WARNING: find_mechanisms hit max_search, consider increasing it\n";
+                return;
+            }
+
+            k = _started++;
+
+            if (_claimed < _starts.size()) {
+                start = &_starts[_claimed++];
+            }
+        }
+
+        dimer = _init;
+
+        if (start && start->saddle) {
+            dimer.activ.view() += start->disp;
+        } else if (start) {
+            dimer.activ.view() += _opt.seed_frac * start->disp;
+        } else {
+            if (_opt.sampling == "halton") {
+                halton_local_pertubation(_init.centre,
+                                         dimer,
+                                         _opt.r_perturbation,
+                                         _opt.stddev,
+                                         k,
+                                         _shift_u,
+                                         _shift_v);
+            } else {
+                random_local_pertubation(_init.centre, dimer, _opt.r_perturbation, _opt.stddev);
+            }
+
+            if (_opt.repulsion > 0) {
+                std::lock_guard lock(_mut);
+                repel(dimer);
+            }
+        }
 
         try {
-            if (finder->find_sp(init, dimer, final, ff)) {
-                double Ei = ff->energy(init);
-                double Es = ff->energy(dimer);
-                double Ef = ff->energy(final);
-
-                ProtoMech mech{{Es - Ei, Ef - Ei, opt.const_pre_factor}, mech_disp(init, final)};
-
-                auto it = std::find_if(mechs.begin(), mechs.end(), [&](ProtoMech const& other) {
-                    return mech.within_tol(other,
-                                           opt.proto.energy_abs_tol,
-                                           opt.proto.energy_frac_tol,
-                                           opt.proto.r_tol);
-                });
-
-                if (it == mechs.end()) {
-                    if (opt.vineyard) {
-                        if (vine.load_sp(dimer, ff)) {
-                            mech.pre_factor = vine.pre_factor();
-                            mechs.push_back(std::move(mech));
-                            count = 0;
-                        }
-                    } else {
-                        mechs.push_back(std::move(mech));
-                        count = 0;
-                    }
-                }
+            bool found = start ? finder->find_sp_along(_init, dimer, start->ax, final, ff)
+                               : finder->find_sp(_init, dimer, final, ff);
+
+            if (start) {
+                start->found = found;
             }
+
+            if (_stats) {
+                _stats->record(finder->grad_calls(), found);
+            }
+
+            if (!found) {
+                std::lock_guard lock(_mut);
+                rediscovered(nullptr);
+                continue;
+            }
+
+            double Ei = ff->energy(_init);
+            double Es = ff->energy(dimer);
+            double Ef = ff->energy(final);
+
+            ProtoMech mech{{Es - Ei, Ef - Ei, _opt.const_pre_factor}, mech_disp(_init, final)};
+
+            mech.sp = dimer.activ.view() - _init.activ.view();
+            mech.ax = finder->axis();
+            mech.drift = final.activ[0].vec - _init.activ[0].vec - mech.disp.segment<3>(0);
+
+            // Cheap test first, avoids computing the prefactor of rediscoveries
+            if (std::lock_guard lock(_mut); !is_new(mech)) {
+                rediscovered(&mech);
+                continue;
+            }
+
+            bool valid = !_opt.vineyard || vine.load_sp(dimer, ff);
+
+            if (valid && _opt.vineyard) {
+                mech.pre_factor = vine.pre_factor();
+            }
+
+            if (valid && _opt.reverse) {
+                mech.rev_pre_factor = _opt.vineyard ? reverse_pre_factor(vine, final, ff)
+                                                    : _opt.const_pre_factor;
+            }
+
+            std::lock_guard lock(_mut);
+
+            // Another batch or cell may have found it in the meantime
+            if (valid && is_new(mech) && (!_registry || _registry->try_insert(mech))) {
+                _mechs.push_back(std::move(mech));
+                _hits.push_back(1);
+                _count = 0;
+            } else {
+                rediscovered(valid ? &mech : nullptr);
+            }
+
         } catch (std::runtime_error const& err) {
             std::cerr << "Caught: " << err.what() << std::endl;
-            count--;
+
+            // A search that threw counts as a failure towards the stopping rule
+            std::lock_guard lock(_mut);
+            rediscovered(nullptr);
         }
     }
+}
+
+void SharedSearch::finish(std::exception_ptr err) {
+    {
+        std::lock_guard lock(_mut);
+
+        if (err && !_error) {
+            _error = err;
+        }
+
+        if (--_batches > 0) {
+            return;
+        }
+    }
+
+    // Last batch out, no other thread can touch the shared state now
+    if (_on_done) {
+        _on_done();
+    }
+
+    if (_error) {
+        _promise.set_exception(_error);
+    } else {
+        _promise.set_value(std::move(_mechs));
+    }
+}
+
+}  // namespace
+
+std::vector<ProtoMech> find_mechanisms(options::FindMechanisms const& opt,
+                                       Workcell const& init,
+                                       std::unique_ptr<PotentialBase>& ff,
+                                       std::unique_ptr<SearchBase>& finder) {
+    std::vector<SearchStart> starts;
+    std::vector<ProtoMech> known;
+
+    SharedSearch search(opt, init, starts, known, 1, {}, nullptr, nullptr);
+
+    std::future mechs = search.get_future();
+
+    std::exception_ptr err = nullptr;
+
+    try {
+        search.run(opt.max_search, ff, finder);
+    } catch (...) {
+        err = std::current_exception();
+    }
+
+    search.finish(err);
+
+    return mechs.get();
+}
+
+std::future<std::vector<ProtoMech>> enqueue_mechanisms(riften::Thiefpool& pool,
+                                                       options::FindMechanisms const& opt,
+                                                       Workcell const& init,
+                                                       std::vector<SearchStart>& starts,
+                                                       std::vector<ProtoMech> const& known,
+                                                       std::unique_ptr<PotentialBase> const& ff,
+                                                       std::unique_ptr<SearchBase> const& finder,
+                                                       std::function<void()> on_done,
+                                                       std::shared_ptr<MechRegistry> registry,
+                                                       std::shared_ptr<SearchStats> stats) {
+    std::size_t batches = std::max<std::size_t>(1, (opt.max_search + opt.batch - 1) / opt.batch);
+
+    auto search = std::make_shared<SharedSearch>(opt,
+                                                 init,
+                                                 starts,
+                                                 known,
+                                                 batches,
+                                                 std::move(on_done),
+                                                 std::move(registry),
+                                                 std::move(stats));
+
+    std::future mechs = search->get_future();
+
+    for (std::size_t i = 0; i < batches; i++) {
+        auto batch = [search, n = opt.batch, f = finder->clone(), p = ff->clone()]() mutable {
+            std::exception_ptr err = nullptr;
+
+            try {
+                search->run(n, p, f);
+            } catch (...) {
+                err = std::current_exception();
+            }
+
+            search->finish(err);
+        };
+
+        pool.enqueue_detach(std::move(batch));
+    }
 
     return mechs;
 }
@@ -1,13 +1,21 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdlib>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <unordered_map>
 
 #include "config.hpp"
 #include "local/environment.hpp"
 #include "minimise/LBFGS/lbfgs.hpp"
+#include "riften/thiefpool.hpp"
 #include "sp_search/sp_search_base.hpp"
 #include "supercell.hpp"
 #include "toml++/toml.h"
@@ -24,8 +32,25 @@ struct FindMechanisms {
     double vine_zero_tol = 1e-7;   // Ignored if vineyard = false
     std::size_t consecutive = 10;  // Number of consecutive rediscoveries before finishing
     std::size_t max_search = 50;   // Maximum number of searches
+    std::size_t batch = 10;        // Searches per task when spread over a pool
     bool vineyard = false;         // Compute prefactor using vineyard approximation
 
+    double seed_frac = 0.5;  // Seeded searches start this fraction along the known mechanism
+
+    std::size_t recycle = 0;  // Number of saddle points kept for recycling across steps, 0 disables
+    double r_recycle = 2.5;   // (Angstroms) Saddles centred this close to a new centre are recycled
+
+    bool reverse = false;  // Register the reverse of each mechanism with its final environment
+
+    // If positive, once a mechanism has been found searching also stops when the Chao1 estimate of
+    // the fraction of the escape rate in unfound mechanisms, from the number of mechanisms found
+    // once and twice, falls below miss_frac. The consecutive rule still applies.
+    double miss_frac = 0;
+    double temp;  // (Kelvin) Weights mechanisms by their rate, only used if miss_frac > 0
+
+    std::string sampling = "random";  // Or "halton" for low-discrepancy perturbation directions
+    double repulsion = 0;             // Fraction of perturbations along found mechanisms removed
+
     Mechanism proto;  // Note: use mech options for Proto-mechanisms
 
     static FindMechanisms load(toml::v2::table const& config);
@@ -33,7 +58,77 @@ struct FindMechanisms {
 
 }  // namespace options
 
+// Known starting point of a saddle search, relative to the initial minimum
+struct SearchStart {
+    VecN<double> disp;    // Displacement of the dimer
+    VecN<double> ax;      // Initial dimer axis (need not be normalised)
+    bool saddle = false;  // If true disp is a saddle point, else a mechanism scaled by seed_frac
+    bool found = false;   // Set once searched, true if the search converged to a saddle point
+};
+
+// Thread-safe set of the mechanisms found by concurrent searches in the same frame, i.e. searches
+// of one supercell centred on different atoms. Mechanisms are keyed by the atom they centre on.
+class MechRegistry {
+  public:
+    explicit MechRegistry(options::Mechanism const& opt) : _opt(opt) {}
+
+    // Test if a mechanism within tolerance of mech has been registered
+    bool contains(ProtoMech const& mech) const;
+
+    // Register mech, returns false if a mechanism within tolerance was already registered
+    bool try_insert(ProtoMech const& mech);
+
+  private:
+    options::Mechanism _opt;
+
+    mutable std::mutex _mut;
+    std::unordered_map<std::size_t, std::vector<ProtoMech>> _mechs;
+
+    // Requires _mut to be held
+    bool contains(std::size_t centre, ProtoMech const& mech) const;
+};
+
+// Gradient evaluations spent by saddle searches, safe to share between concurrent searches
+class SearchStats {
+  public:
+    // Record one search that used grads gradient evaluations
+    void record(std::size_t grads, bool converged) {
+        _grads += grads;
+        _saddles += converged;
+    }
+
+    // Mean gradient evaluations per converged saddle point, failed searches included, zero if the
+    // searcher does not count them.
+    double grads_per_saddle() const {
+        std::size_t saddles = _saddles;
+        return saddles > 0 ? double(_grads) / saddles : 0;
+    }
+
+  private:
+    std::atomic<std::size_t> _grads = 0;
+    std::atomic<std::size_t> _saddles = 0;
+};
+
 std::vector<ProtoMech> find_mechanisms(options::FindMechanisms const& opt,
                                        Workcell const& init,
                                        std::unique_ptr<PotentialBase>& ff,
                                        std::unique_ptr<SearchBase>& finder);
+
+// Split the search budget of init into batches of opt.batch searches and enqueue them on pool,
+// batches share one result set and the stopping rule counts rediscoveries across all of them.
+// The future resolves once every batch has finished, on_done is called just before. Searches
+// begin from each of the starts before random perturbations and record their outcome in
+// SearchStart::found. Mechanisms in known count as rediscoveries and are not returned. Init, starts
+// and known must outlive the future. If a registry is given, mechanisms already registered by
+// another cell count as rediscoveries and are not returned, every mechanism returned is registered.
+// If stats is given, every search is recorded in it.
+std::future<std::vector<ProtoMech>> enqueue_mechanisms(riften::Thiefpool& pool,
+                                                       options::FindMechanisms const& opt,
+                                                       Workcell const& init,
+                                                       std::vector<SearchStart>& starts,
+                                                       std::vector<ProtoMech> const& known,
+                                                       std::unique_ptr<PotentialBase> const& ff,
+                                                       std::unique_ptr<SearchBase> const& finder,
+                                                       std::function<void()> on_done = {},
+                                                       std::shared_ptr<MechRegistry> registry = {},
+                                                       std::shared_ptr<SearchStats> stats = {});
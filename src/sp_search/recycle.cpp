@@ -0,0 +1,56 @@
+#include "sp_search/recycle.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "local/environment.hpp"
+#include "supercell.hpp"
+#include "utility.hpp"
+
+void SaddleCache::insert(ProtoMech const& mech, std::vector<std::size_t> const& map) {
+    if (_capacity == 0 || mech.sp.size() == 0) {
+        return;
+    }
+
+    CHECK(mech.sp.size() == 3 * static_cast<std::ptrdiff_t>(map.size()), "Map does not fit mech");
+
+    Saddle& saddle = _saddles.emplace_back();
+
+    saddle.centre = map[mech.find_centre()];
+
+    for (std::size_t i = 0; i < map.size(); i++) {
+        Vec3<double> dr = mech.sp.segment<3>(3 * i);
+
+        if (norm(dr) > _disp_tol) {
+            saddle.idx.push_back(map[i]);
+            saddle.disp.push_back(dr);
+            // Without an axis from the searcher start along the saddle point
+            saddle.ax.push_back(mech.ax.size() > 0 ? Vec3<double>{mech.ax.segment<3>(3 * i)} : dr);
+        }
+    }
+
+    if (saddle.idx.empty()) {
+        _saddles.pop_back();
+    } else if (_saddles.size() > _capacity) {
+        _saddles.pop_front();
+    }
+}
+
+std::vector<Saddle> SaddleCache::take(Supercell const& cell, std::size_t centre) {
+    std::vector<Saddle> out;
+
+    Vec3<double> cen = cell.activ[centre].vec;
+
+    for (auto it = _saddles.begin(); it != _saddles.end();) {
+        if (norm_sq(cell.min_image(cell.activ[it->centre].vec, cen)) < _r_recycle * _r_recycle) {
+            out.push_back(std::move(*it));
+            it = _saddles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "config.hpp"
+#include "sp_search/find_mech.hpp"
+#include "supercell.hpp"
+
+// A converged saddle point in the frame of a supercell, sparse over the atoms that moved.
+struct Saddle {
+    std::size_t centre;              // Atom with the largest displacement
+    std::vector<std::size_t> idx;    // Active atoms displaced more than disp_tol
+    std::vector<Vec3<double>> disp;  // Displacement of each atom in idx from the initial minimum
+    std::vector<Vec3<double>> ax;    // Dimer axis at the saddle point, per atom in idx
+};
+
+// Fixed capacity store of recently converged saddle points. Saddle points away from the atoms
+// moved by a mechanism usually survive it, hence searches in new environments start by
+// re-converging the saddle points centred near them before resorting to random perturbations.
+class SaddleCache {
+  public:
+    explicit SaddleCache(options::FindMechanisms const& opt)
+        : _capacity(opt.recycle), _r_recycle(opt.r_recycle), _disp_tol(opt.proto.disp_tol) {}
+
+    // Store the saddle point of a mechanism found in cell, map[i] is the index in cell of the ith
+    // active atom of the mechanism. Evicts the oldest saddle points when full.
+    void insert(ProtoMech const& mech, std::vector<std::size_t> const& map);
+
+    // Remove and return the saddle points centred within .r_recycle of atom centre of cell
+    std::vector<Saddle> take(Supercell const& cell, std::size_t centre);
+
+    // Count the outcome of re-converging a recycled saddle point
+    void record(bool found) {
+        ++_num_tried;
+        _num_found += found;
+    }
+
+    // Fraction of recycled saddle points that re-converged
+    double hit_rate() const {
+        return _num_tried > 0 ? static_cast<double>(_num_found) / _num_tried : 0;
+    }
+
+  private:
+    std::size_t _capacity;
+    double _r_recycle;
+    double _disp_tol;
+
+    std::deque<Saddle> _saddles;  // Oldest first
+
+    std::size_t _num_tried = 0;
+    std::size_t _num_found = 0;
+};
@@ -0,0 +1,206 @@
+#include "sp_search/region.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "config.hpp"
+#include "potentials/potential_base.hpp"
+#include "supercell.hpp"
+#include "toml++/toml.h"
+#include "utility.hpp"
+
+namespace options {
+
+RegionSPS RegionSPS::load(toml::v2::table const& config) {
+    RegionSPS opt;
+
+    opt.r_region = fetch<double>(config, "sp_search", "region", "r_region");
+
+    opt.disp_tol = config["sp_search"]["region"]["disp_tol"].value_or(opt.disp_tol);
+    opt.max_grow = config["sp_search"]["region"]["max_grow"].value_or(opt.max_grow);
+
+    return opt;
+}
+
+}  // namespace options
+
+bool RegionSPS::find_sp(Supercell const& init,
+                        Supercell& dimer,
+                        Supercell& final,
+                        std::unique_ptr<PotentialBase>& ff) {
+    return search(init, dimer, {}, final, ff);
+}
+
+bool RegionSPS::find_sp_along(Supercell const& init,
+                              Supercell& dimer,
+                              VecN<double> const& ax,
+                              Supercell& final,
+                              std::unique_ptr<PotentialBase>& ff) {
+    return search(init, dimer, ax, final, ff);
+}
+
+bool RegionSPS::search(Supercell const& init,
+                       Supercell& dimer,
+                       VecN<double> const& ax,
+                       Supercell& final,
+                       std::unique_ptr<PotentialBase>& ff) {
+    // Start from an empty region
+    _moving.clear();
+    _is_moving.assign(init.activ.size(), false);
+    _free.assign(init.activ.size(), false);
+
+    build(init, dimer, ff->rcut());
+
+    _ax = ax;
+    _grad_calls = 0;
+
+    for (std::size_t i = 0;; i++) {
+        //
+        restrict(dimer, _sub_dimer);
+
+        bool found = false;
+
+        if (_ax.size() > 0) {
+            VecN<double> sub_ax(3 * _map.size());
+
+            for (std::size_t k = 0; k < _map.size(); k++) {
+                sub_ax.segment<3>(3 * k) = _ax.segment<3>(3 * _map[k]);
+            }
+
+            found = _inner->find_sp_along(_sub_init, _sub_dimer, sub_ax, _sub_final, ff);
+        } else {
+            found = _inner->find_sp(_sub_init, _sub_dimer, _sub_final, ff);
+        }
+
+        _grad_calls += _inner->grad_calls();
+
+        if (!found) {
+            return false;
+        }
+
+        expand(_sub_dimer, init, dimer);
+
+        // Resume along the axis at the saddle point
+        if (VecN<double> sub_ax = _inner->axis(); sub_ax.size() > 0) {
+            _ax = VecN<double>::Zero(3 * init.activ.size());
+
+            for (std::size_t k = 0; k < _map.size(); k++) {
+                _ax.segment<3>(3 * _map[k]) = sub_ax.segment<3>(3 * k);
+            }
+        } else {
+            _ax = dimer.activ.view() - init.activ.view();
+        }
+
+        if (!build(init, dimer, ff->rcut())) {
+            expand(_sub_final, init, final);
+            return true;
+        }
+
+        if (i == _opt.max_grow) {
+            return false;
+        }
+    }
+}
+
+bool RegionSPS::build(Supercell const& init, Supercell const& dimer, double rcut) {
+    //
+    std::size_t num_moving = _moving.size();
+
+    // Always build around the atom that moved furthest
+    std::size_t far = 0;
+    double far_sq = -1;
+
+    for (std::size_t i = 0; i < init.activ.size(); i++) {
+        double dr_sq = norm_sq(dimer.activ[i].vec - init.activ[i].vec);
+
+        if (dr_sq > far_sq) {
+            far = i;
+            far_sq = dr_sq;
+        }
+
+        if (dr_sq > _opt.disp_tol * _opt.disp_tol && !_is_moving[i]) {
+            _is_moving[i] = true;
+            _moving.push_back(i);
+        }
+    }
+
+    if (_moving.empty()) {
+        _is_moving[far] = true;
+        _moving.push_back(far);
+    }
+
+    if (_moving.size() == num_moving) {
+        return false;
+    }
+
+    double r_free = _opt.r_region;
+    double r_bound = _opt.r_region + 2 * rcut;
+
+    // Squared distance from each atom to the nearest moving atom
+    auto near_sq = [&](Vec3<double> const& vec) {
+        double min = r_bound * r_bound;
+
+        for (auto&& m : _moving) {
+            min = std::min(min, norm_sq(init.min_image(init.activ[m].vec, vec)));
+        }
+
+        return min;
+    };
+
+    bool grew = false;
+
+    for (std::size_t i = 0; i < init.activ.size(); i++) {
+        if (!_free[i] && near_sq(init.activ[i].vec) < r_free * r_free) {
+            _free[i] = true;
+            grew = true;
+        }
+    }
+
+    // Moving atoms deep inside the region do not grow it, keep the sub-cells of the last search
+    if (!grew) {
+        return false;
+    }
+
+    _map.clear();
+
+    static_cast<Simbox&>(_sub_init) = static_cast<Simbox const&>(init);
+
+    _sub_init.activ.clear();
+    _sub_init.bound.clear();
+
+    for (std::size_t i = 0; i < init.activ.size(); i++) {
+        if (_free[i]) {
+            _map.push_back(i);
+            _sub_init.activ.emplace_back(init.activ[i].vec, init.activ[i].col);
+        } else if (near_sq(init.activ[i].vec) < r_bound * r_bound) {
+            _sub_init.bound.emplace_back(init.activ[i].vec, init.activ[i].col);
+        }
+    }
+
+    for (std::size_t i = 0; i < init.bound.size(); i++) {
+        if (near_sq(init.bound[i].vec) < r_bound * r_bound) {
+            _sub_init.bound.emplace_back(init.bound[i].vec, init.bound[i].col);
+        }
+    }
+
+    _sub_dimer = _sub_init;
+    _sub_final = _sub_init;
+
+    return true;
+}
+
+void RegionSPS::restrict(Supercell const& src, Supercell& sub) const {
+    for (std::size_t k = 0; k < _map.size(); k++) {
+        sub.activ[k].vec = src.activ[_map[k]].vec;
+    }
+}
+
+void RegionSPS::expand(Supercell const& sub, Supercell const& init, Supercell& dst) const {
+    dst.activ.view() = init.activ.view();
+
+    for (std::size_t k = 0; k < _map.size(); k++) {
+        dst.activ[_map[k]].vec = sub.activ[k].vec;
+    }
+}
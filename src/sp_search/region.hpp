@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "potentials/potential_base.hpp"
+#include "sp_search/sp_search_base.hpp"
+#include "supercell.hpp"
+#include "toml++/toml.h"
+
+namespace options {
+
+struct RegionSPS {
+    double r_region;           // (Angstroms) Atoms this close to a moving atom are free to move
+    double disp_tol = 0.1;     // (Angstroms) Atoms displaced further than this are moving
+    std::size_t max_grow = 4;  // Number of times the region may grow before the search fails
+
+    static RegionSPS load(toml::v2::table const& config);
+};
+
+}  // namespace options
+
+// Wraps another saddle-point searcher such that it only sees the atoms near those that move. The
+// searcher works on a cell holding the atoms within .r_region of a moving atom as active and the
+// atoms within 2 * rcut of those as bound (frozen), all other atoms are dropped. If the converged
+// saddle point moves atoms near the edge of the region, the region is rebuilt around the new set
+// of moving atoms and the search resumes from the saddle point, hence the region grows to follow
+// the mechanism. Results are mapped back onto the full cell, atoms outside the region stay at init.
+class RegionSPS final : public SearchBase {
+  public:
+    RegionSPS(std::unique_ptr<SearchBase> inner, options::RegionSPS const& opt)
+        : _inner(std::move(inner)), _opt(opt) {}
+
+    std::unique_ptr<SearchBase> clone() const override {
+        return std::make_unique<RegionSPS>(_inner->clone(), _opt);
+    }
+
+    bool find_sp(Supercell const& init,
+                 Supercell& dimer,
+                 Supercell& final,
+                 std::unique_ptr<PotentialBase>& ff) override;
+
+    bool find_sp_along(Supercell const& init,
+                       Supercell& dimer,
+                       VecN<double> const& ax,
+                       Supercell& final,
+                       std::unique_ptr<PotentialBase>& ff) override;
+
+    VecN<double> axis() const override { return _ax; }
+
+    std::size_t grad_calls() const override { return _grad_calls; }
+
+  private:
+    std::unique_ptr<SearchBase> _inner;
+    options::RegionSPS _opt;
+
+    std::vector<std::size_t> _moving;  // Active atoms of the full cell the region is built around
+    std::vector<bool> _is_moving;      // True for active atoms of the full cell in _moving
+    std::vector<std::size_t> _map;     // Active atom in region -> active atom in full cell
+    std::vector<bool> _free;           // True for active atoms of the full cell in the region
+
+    VecN<double> _ax;  // Axis of the last saddle point in the full cell
+
+    std::size_t _grad_calls = 0;  // Summed over every inner search of the last search
+
+    Supercell _sub_init;
+    Supercell _sub_dimer;
+    Supercell _sub_final;
+
+    // Search with the initial axis ax (in the full cell) or a random axis if ax is empty
+    bool search(Supercell const& init,
+                Supercell& dimer,
+                VecN<double> const& ax,
+                Supercell& final,
+                std::unique_ptr<PotentialBase>& ff);
+
+    // Grow the region around the atoms of dimer displaced from init, returns true if it grew. The
+    // sub-cells, hence the last saddle point and final minimum, are only rebuilt if it grew.
+    bool build(Supercell const& init, Supercell const& dimer, double rcut);
+
+    // Copy the region of the full cell src into the active atoms of sub
+    void restrict(Supercell const& src, Supercell& sub) const;
+
+    // Copy the active atoms of sub into the region of dst, other active atoms are taken from init
+    void expand(Supercell const& sub, Supercell const& init, Supercell& dst) const;
+};
@@ -3,17 +3,21 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "config.hpp"
+#include "sp_search/dimer/artn.hpp"
 #include "sp_search/dimer/dimer.hpp"
 #include "sp_search/dimer/l_shrink.hpp"
 #include "sp_search/dimer/search.hpp"
 #include "sp_search/dimer/shrinking.hpp"
+#include "sp_search/region.hpp"
 #include "toml++/toml.h"
 #include "utility.hpp"
 
-// Customisation point, dynamically select minimiser
-std::unique_ptr<SearchBase> load_sp_search(toml::v2::table const& config) {
+namespace {
+
+std::unique_ptr<SearchBase> load_kind(toml::v2::table const& config) {
     //
     std::string kind = fetch<std::string>(config, "sp_search", "kind");
 
@@ -26,7 +30,24 @@ std::unique_ptr<SearchBase> load_sp_search(toml::v2::table const& config) {
     } else if (kind == "Shrinking") {
         return std::make_unique<DimerSPS<ShrinkingDimer>>(
             load_minimiser(config), ShrinkingDimer{options::ShrinkingDimer::load(config)});
+    } else if (kind == "ARTn") {
+        return std::make_unique<DimerSPS<ARTn>>(load_minimiser(config),
+                                                ARTn{options::ARTn::load(config)});
     } else {
         throw std::runtime_error("Unsupported minimise field selected : " + kind);
     }
-}
\ No newline at end of file
+}
+
+}  // namespace
+
+// Customisation point, dynamically select minimiser
+std::unique_ptr<SearchBase> load_sp_search(toml::v2::table const& config) {
+    //
+    std::unique_ptr<SearchBase> finder = load_kind(config);
+
+    if (config["sp_search"]["region"]["enable"].value_or(false)) {
+        return std::make_unique<RegionSPS>(std::move(finder), options::RegionSPS::load(config));
+    }
+
+    return finder;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 
@@ -22,6 +23,25 @@ class SearchBase {
                          std::unique_ptr<PotentialBase>& ff)
         = 0;
 
+    // As find_sp but the search starts from dimer with its axis along ax, used when dimer is
+    // displaced along a known mechanism or placed at a known saddle point. Defaults to find_sp for
+    // searchers that cannot use the hint.
+    virtual bool find_sp_along(Supercell const& init,
+                               Supercell& dimer,
+                               VecN<double> const& ax,
+                               Supercell& final,
+                               std::unique_ptr<PotentialBase>& ff) {
+        return find_sp(init, dimer, final, ff);
+    }
+
+    // Axis of the dimer at the saddle point found by the last successful search, empty if the
+    // searcher does not track one.
+    virtual VecN<double> axis() const { return {}; }
+
+    // Gradient evaluations used by the last call to find_sp or find_sp_along to reach (or fail to
+    // reach) a saddle point, excludes the relaxation to the final minimum. Zero if not counted.
+    virtual std::size_t grad_calls() const { return 0; }
+
     // Call parent destructor
     virtual ~SearchBase() {}
 
@@ -228,11 +228,15 @@ std::map<std::string, Colour> species_map_to_colour(
 std::pair<Supercell, std::string> load_supercell(
     toml::v2::table const &config,
     std::unordered_map<std::string, std::uint16_t> const &species_map) {
+    return load_supercell(config, species_map, fetch<std::string>(config, "supercell", "in_file"));
+}
+
+std::pair<Supercell, std::string> load_supercell(
+    toml::v2::table const &config,
+    std::unordered_map<std::string, std::uint16_t> const &species_map,
+    std::string const &in_file) {
     //
-    std::pair<Supercell, std::string> out{
-        Simbox::load(config),
-        fetch<std::string>(config, "supercell", "in_file"),
-    };
+    std::pair<Supercell, std::string> out{Simbox::load(config), in_file};
 
     // Parse xyz file
     std::ifstream file(out.second);
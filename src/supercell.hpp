@@ -175,6 +175,12 @@ std::pair<Supercell, std::string> load_supercell(
     toml::v2::table const &config,
     std::unordered_map<std::string, std::uint16_t> const &);
 
+// As above but reads "in_file" instead of supercell.in_file
+std::pair<Supercell, std::string> load_supercell(
+    toml::v2::table const &config,
+    std::unordered_map<std::string, std::uint16_t> const &species_map,
+    std::string const &in_file);
+
 // In LAMMPS compatible .xyz file
 void dump_supercell(Supercell const &cell, std::string const &out_file, bool append = false);
 